@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+// Standalone benchmark of the unfolding engines, built without R (see Makefile in this directory).
+// Synthetic problems are drawn with randomDelta() and randomZ() over a grid of n, m, p, sparsity, and sign pattern.
+// Each engine reports iterations per second, time to reach its final stress within 1%, peak resident set size,
+// and a model estimate of GFLOP/s, one JSON record per run on stdout. External unfolding reports the mean loss and
+// the average number of iterations per row, the ultrafast engine its number of learning rate steps, each of n + m updates.
+// Sparsity only applies to the engines that take weights, the others run on the dense problems only.
+//
+// usage: bench [quick] [maxiter]
+
+#include <sys/resource.h>
+
+#include "../../src/fmdu.h"
+
+static double seconds( const uint64_t start )
+{
+  return getelapsedtime( start );
+} // seconds
+
+static long peakrss( void )
+// peak resident set size of the process in kilobytes
+{
+  struct rusage usage;
+  if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) return 0;
+  return usage.ru_maxrss;
+} // peakrss
+
+static void problem( const size_t n, const size_t m, const size_t p, const double sparsity, const bool negative, const long seed, double** delta, double** w )
+// draws an n by m block of dissimilarities among n + m objects in p dimensions, clamped at zero against the error,
+// with sparsity weights set to zero and, for a mixed sign pattern, one in ten dissimilarities negated
+{
+  int* vdist = getivector( p, 1 );
+  double* vssq = getvector( p, 1.0 );
+  double** full = getmatrix( n + m, n + m, 0.0 );
+  randomDelta( n + m, p, vdist, vssq, 2, 0.1, seed, full );
+  for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= m; j++ ) delta[i][j] = fmax( 0.0, full[i][n + j] );
+  long tmpseed = seed + 1;
+  randomize( &tmpseed );
+  for ( size_t i = 1; i <= n; i++ ) {
+    for ( size_t j = 1; j <= m; j++ ) {
+      w[i][j] = ( nextdouble( ) < sparsity ? 0.0 : 1.0 );
+      if ( negative == true && nextdouble( ) < 0.1 ) delta[i][j] = -1.0 * delta[i][j];
+    }
+  }
+  freeivector( vdist );
+  freevector( vssq );
+  freematrix( full );
+} // problem
+
+static double timetotarget( const fitcontrol* control )
+// seconds until the traced stress is within 1% of the final stress, negative without trace
+{
+  if ( control->ntrace == 0 ) return -1.0;
+  const size_t rows = control->tracesize;
+  const double target = 1.01 * control->trace[rows + control->ntrace - 1];
+  double elapsed = 0.0;
+  for ( size_t k = 0; k < control->ntrace; k++ ) {
+    elapsed += control->trace[3 * rows + k];
+    if ( control->trace[rows + k] <= target ) break;
+  }
+  return elapsed;
+} // timetotarget
+
+static void report( const char* engine, const size_t n, const size_t m, const size_t p, const double sparsity, const bool negative, const size_t iterations, const double flops, const double time, const double target, const double stress, bool* first )
+// prints one JSON record, flops is the model estimate of the floating point operations of the run
+{
+  printf( "%s  {\"engine\": \"%s\", \"n\": %zu, \"m\": %zu, \"p\": %zu, \"sparsity\": %.2f, \"sign\": \"%s\", ", ( *first ? "" : ",\n" ), engine, n, m, p, sparsity, ( negative ? "mixed" : "positive" ) );
+  printf( "\"iterations\": %zu, \"seconds\": %.6f, \"iterations_per_second\": %.3f, ", iterations, time, ( time > 0.0 ? ( double )( iterations ) / time : 0.0 ) );
+  if ( target < 0.0 ) printf( "\"time_to_target\": null, " );
+  else printf( "\"time_to_target\": %.6f, ", target );
+  printf( "\"stress\": %.10f, \"peak_rss_kb\": %ld, \"gflops\": %.3f}", stress, peakrss( ), ( time > 0.0 ? 1.0e-9 * flops / time : 0.0 ) );
+  fflush( stdout );
+  ( *first ) = false;
+} // report
+
+static void run( const size_t n, const size_t m, const size_t p, const double sparsity, const bool negative, const size_t MAXITER, bool* first )
+{
+  const double FCRIT = 1.0e-8;
+  const long seed = ( long )( 1000 * n + 10 * m + p );
+  const size_t h = p + 1;
+
+  // allocate memory
+  double** delta = getmatrix( n, m, 0.0 );
+  double** w = getmatrix( n, m, 1.0 );
+  double** x = getmatrix( n, p, 0.0 );
+  double** y = getmatrix( m, p, 0.0 );
+  int** fx = getimatrix( n, p, 0 );
+  int** fy = getimatrix( m, p, 0 );
+  double** d = getmatrix( n, m, 0.0 );
+  double** q = getmatrix( n, h, 0.0 );
+  double** qc = getmatrix( m, h, 0.0 );
+  double** b = getmatrix( h, p, 0.0 );
+  double* trace = getvector( TRACECOLUMNS * ( MAXITER + 1 ), 0.0 );
+  problem( n, m, p, sparsity, negative, seed, delta, w );
+  randomZ( n, h, q, seed + 2 );
+  randomZ( m, h, qc, seed + 3 );
+
+  size_t lastiter = 0;
+  double lastdif = 0.0;
+  double stress = 0.0;
+  uint64_t start = 0;
+  fitcontrol control;
+
+  // full configuration kernels, only the weighted kernel sees the sparsity pattern
+  const char* names[3] = { "mdu", "wgtmdu", "mduneg" };
+  for ( int engine = 0; engine < 3; engine++ ) {
+    if ( ( engine == 1 ) != ( sparsity > 0.0 ) ) continue;
+    if ( ( engine == 2 ) != negative ) continue;
+    randomZ( n, p, x, seed + 4 );
+    randomZ( m, p, y, seed + 5 );
+    control = setcontrol( NULL, 0, 0, 0.0 );
+    settrace( &control, &trace[1], ( int )( MAXITER + 1 ), 0 );
+    start = setstarttime( );
+    if ( engine == 0 ) stress = mdu( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, false, &control, false );
+    else if ( engine == 1 ) stress = wgtmdu( n, m, delta, w, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, false );
+    else stress = mduneg( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, false );
+    report( names[engine], n, m, p, sparsity, negative, min_t( lastiter, MAXITER ), min_t( lastiter, MAXITER ) * ( 9.0 * n * m * p + 8.0 * n * m ), seconds( start ), timetotarget( &control ), stress, first );
+  }
+
+  // restricted kernels, unweighted and nonnegative dissimilarities only
+  if ( negative == false && sparsity == 0.0 ) {
+    randomZ( h, p, b, seed + 6 );
+    randomZ( m, p, y, seed + 5 );
+    control = setcontrol( NULL, 0, 0, 0.0 );
+    settrace( &control, &trace[1], ( int )( MAXITER + 1 ), 0 );
+    start = setstarttime( );
+    design* dq = newdesign( n, h, q );
+    stress = rowresmdu( n, m, delta, p, dq, b, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, false );
+    freedesign( dq );
+    report( "rowresmdu", n, m, p, sparsity, negative, min_t( lastiter, MAXITER ), min_t( lastiter, MAXITER ) * ( 9.0 * n * m * p + 8.0 * n * m ), seconds( start ), timetotarget( &control ), stress, first );
+
+    randomZ( h, p, b, seed + 6 );
+    randomZ( n, p, x, seed + 4 );
+    control = setcontrol( NULL, 0, 0, 0.0 );
+    settrace( &control, &trace[1], ( int )( MAXITER + 1 ), 0 );
+    start = setstarttime( );
+    dq = newdesign( m, h, qc );
+    stress = colresmdu( n, m, delta, p, x, fx, dq, b, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, false );
+    freedesign( dq );
+    report( "colresmdu", n, m, p, sparsity, negative, min_t( lastiter, MAXITER ), min_t( lastiter, MAXITER ) * ( 9.0 * n * m * p + 8.0 * n * m ), seconds( start ), timetotarget( &control ), stress, first );
+  }
+
+  // external unfolding of the rows given random column coordinates, external() returns the sum of the normalized
+  // losses of the rows, reported as their mean
+  if ( negative == false ) {
+    size_t* iters = getvector_t( n, 0 );
+    double* difs = getvector( n, 0.0 );
+    randomZ( m, p, y, seed + 5 );
+    randomZ( n, p, x, seed + 4 );
+    start = setstarttime( );
+    stress = external( n, m, delta, w, p, y, x, d, MAXITER, FCRIT, iters, difs, NULL, NULL, false, 1 );
+    const double time = seconds( start );
+    size_t total = 0;
+    for ( size_t i = 1; i <= n; i++ ) total += min_t( iters[i], MAXITER );
+    report( "external", n, m, p, sparsity, negative, total / n, total * m * ( 4.0 * p + 8.0 ), time, -1.0, stress / ( double )( n ), first );
+    freevector_t( iters );
+    freevector( difs );
+  }
+
+  // stochastic engine on row major data, one step is n + m updates
+  if ( negative == false && sparsity == 0.0 ) {
+    double* data = ( double* ) calloc( n * m, sizeof( double ) );
+    double* px = ( double* ) calloc( n * p, sizeof( double ) );
+    double* py = ( double* ) calloc( m * p, sizeof( double ) );
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= m; j++ ) data[( i - 1 ) * m + j - 1] = delta[i][j];
+    randomZ( n, p, x, seed + 4 );
+    randomZ( m, p, y, seed + 5 );
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) px[( i - 1 ) * p + k - 1] = x[i][k];
+    for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) py[( j - 1 ) * p + k - 1] = y[j][k];
+    int rn = ( int )( n ), rm = ( int )( m ), rp = ( int )( p ), rnsteps = ( int )( MAXITER ), rseed = ( int )( seed ), rschedule = 0;
+    int rinterval = 0, rfirstiter = 0, rstatus = 0;
+    double rminrate = 1.0e-8, rbudget = 0.0;
+    double rstate[3] = { 0.0, 0.0, 0.0 };
+    unsigned char rrng[CHECKPOINTRNGSIZE] = { 0 };
+    char* rcheckpoint = "";
+    start = setstarttime( );
+    CRultrafastmdu( &rn, &rm, data, &rp, px, py, &rnsteps, &rminrate, &rseed, &rschedule, &rcheckpoint, &rinterval, &rfirstiter, rstate, rrng, &rbudget, &rstatus );
+    const double time = seconds( start );
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) x[i][k] = px[( i - 1 ) * p + k - 1];
+    for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) y[j][k] = py[( j - 1 ) * p + k - 1];
+    euclidean2( n, p, x, m, y, d );
+    double ssr = 0.0;
+    double ssd = 0.0;
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= m; j++ ) {
+      ssr += ( delta[i][j] - d[i][j] ) * ( delta[i][j] - d[i][j] );
+      ssd += delta[i][j] * delta[i][j];
+    }
+    report( "ultrafastmdu", n, m, p, sparsity, negative, MAXITER, MAXITER * ( n + m ) * ( 6.0 * p + 8.0 ), time, -1.0, ssr / ssd, first );
+    free( data );
+    free( px );
+    free( py );
+  }
+
+  // de-allocate memory
+  freematrix( delta );
+  freematrix( w );
+  freematrix( x );
+  freematrix( y );
+  freeimatrix( fx );
+  freeimatrix( fy );
+  freematrix( d );
+  freematrix( q );
+  freematrix( qc );
+  freematrix( b );
+  freevector( trace );
+} // run
+
+int main( int argc, char** argv )
+{
+  const bool quick = ( argc > 1 && strcmp( argv[1], "quick" ) == 0 );
+  const size_t MAXITER = ( argc > 2 ? ( size_t )( atol( argv[2] ) ) : 256 );
+
+  // grid of problem sizes and patterns
+  const size_t vn[3] = { 100, 400, 1600 };
+  const size_t vm[2] = { 20, 200 };
+  const size_t vp[2] = { 2, 3 };
+  const double vsparsity[2] = { 0.0, 0.5 };
+  const size_t nn = ( quick ? 1 : 3 );
+  const size_t nm = ( quick ? 1 : 2 );
+
+  bool first = true;
+  printf( "[\n" );
+  for ( size_t in = 0; in < nn; in++ ) {
+    for ( size_t im = 0; im < nm; im++ ) {
+      for ( size_t ip = 0; ip < 2; ip++ ) {
+        for ( size_t is = 0; is < 2; is++ ) {
+          for ( int sign = 0; sign < 2; sign++ ) run( vn[in], vm[im], vp[ip], vsparsity[is], sign == 1, MAXITER, &first );
+        }
+      }
+    }
+  }
+  printf( "\n]\n" );
+  return 0;
+} // main
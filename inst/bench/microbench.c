@@ -0,0 +1,374 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+// Microbenchmark of the flib numerical primitives, built without R (see Makefile in this directory).
+// Each primitive runs over working sets from L1 to DRAM against a naive reference loop and, when built with
+// FMDU_CBLAS, the system BLAS. The table reports cycles per element (time stamp counter on x86, nanoseconds
+// elsewhere), the minimum over TRIALS runs. An element is one vector entry, one matrix entry for dgemv, one
+// multiply-add for dgemm, one distance for euclidean1/2 and fdist, one n^3 unit for the decompositions, and one
+// n log2 n unit for dsort.
+//
+// usage: microbench [quick]
+
+#include "../../src/fmdu.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+  #include <x86intrin.h>
+  #define TICKS( ) ( ( double )( __rdtsc( ) ) )
+  #define TICKUNIT "cycles"
+#else
+  #define TICKS( ) ( ( double )( setstarttime( ) ) )
+  #define TICKUNIT "ns"
+#endif
+
+#ifdef FMDU_CBLAS
+  #include <cblas.h>
+#endif
+
+#define TRIALS 5
+#define WORK 20000000.0
+
+static volatile double sink = 0.0;
+
+// naive references
+
+static double naivedot( const size_t n, const double* a, const double* b )
+{
+  double s = 0.0;
+  for ( size_t i = 0; i < n; i++ ) s += a[i] * b[i];
+  return s;
+}
+
+static double naivewdot( const size_t n, const double* a, const double* b, const double* w )
+{
+  double s = 0.0;
+  for ( size_t i = 0; i < n; i++ ) s += a[i] * w[i] * b[i];
+  return s;
+}
+
+static void naiveaxpy( const size_t n, const double c, const double* a, double* b )
+{
+  for ( size_t i = 0; i < n; i++ ) b[i] += c * a[i];
+}
+
+static void naivescal( const size_t n, const double c, double* a )
+{
+  for ( size_t i = 0; i < n; i++ ) a[i] *= c;
+}
+
+static double naivesum( const size_t n, const double* a )
+{
+  double s = 0.0;
+  for ( size_t i = 0; i < n; i++ ) s += a[i];
+  return s;
+}
+
+static void naivegemv( const size_t n, double** a, const double* b, double* c )
+{
+  for ( size_t i = 1; i <= n; i++ ) {
+    double s = 0.0;
+    for ( size_t j = 1; j <= n; j++ ) s += a[i][j] * b[j];
+    c[i] = s;
+  }
+}
+
+static void naivegemm( const size_t n, double** a, double** b, double** c )
+{
+  for ( size_t i = 1; i <= n; i++ ) {
+    for ( size_t j = 1; j <= n; j++ ) {
+      double s = 0.0;
+      for ( size_t k = 1; k <= n; k++ ) s += a[i][k] * b[k][j];
+      c[i][j] = s;
+    }
+  }
+}
+
+static void naiveeuclidean( const size_t n, const size_t p, double** a, const size_t m, double** b, double** r )
+{
+  for ( size_t i = 1; i <= n; i++ ) {
+    for ( size_t j = 1; j <= m; j++ ) {
+      double s = 0.0;
+      for ( size_t k = 1; k <= p; k++ ) s += ( a[i][k] - b[j][k] ) * ( a[i][k] - b[j][k] );
+      r[i][j] = sqrt( s );
+    }
+  }
+}
+
+static double naivedist( const size_t p, const double* x, const double* y )
+{
+  double s = 0.0;
+  for ( size_t k = 0; k < p; k++ ) s += ( x[k] - y[k] ) * ( x[k] - y[k] );
+  return sqrt( s );
+}
+
+static void naiveinverse( const size_t n, double** a )
+// gauss-jordan elimination with partial pivoting
+{
+  double** w = getmatrix( n, 2 * n, 0.0 );
+  for ( size_t i = 1; i <= n; i++ ) {
+    for ( size_t j = 1; j <= n; j++ ) w[i][j] = a[i][j];
+    w[i][n + i] = 1.0;
+  }
+  for ( size_t k = 1; k <= n; k++ ) {
+    size_t piv = k;
+    for ( size_t i = k + 1; i <= n; i++ ) if ( fabs( w[i][k] ) > fabs( w[piv][k] ) ) piv = i;
+    if ( piv != k ) for ( size_t j = 1; j <= 2 * n; j++ ) {
+      const double t = w[k][j];
+      w[k][j] = w[piv][j];
+      w[piv][j] = t;
+    }
+    const double pk = w[k][k];
+    for ( size_t j = 1; j <= 2 * n; j++ ) w[k][j] /= pk;
+    for ( size_t i = 1; i <= n; i++ ) if ( i != k ) {
+      const double f = w[i][k];
+      for ( size_t j = 1; j <= 2 * n; j++ ) w[i][j] -= f * w[k][j];
+    }
+  }
+  for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= n; j++ ) a[i][j] = w[i][n + j];
+  freematrix( w );
+}
+
+static int compare( const void* a, const void* b )
+{
+  const double da = *( const double* ) a;
+  const double db = *( const double* ) b;
+  return ( da > db ) - ( da < db );
+}
+
+static void fill( const size_t n, const size_t m, double** a, long seed )
+// uniform random entries, randomZ() draws inside the unit ball and is meant for few columns
+{
+  randomize( &seed );
+  for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= m; j++ ) a[i][j] = nextdouble( );
+}
+
+// timing
+
+static size_t repetitions( const double elements )
+{
+  const double reps = WORK / elements;
+  return ( reps < 1.0 ? 1 : ( size_t )( reps ) );
+}
+
+static void row( const char* name, const size_t size, const double bytes, const double flib, const double naive, const double blas )
+{
+  printf( "%-12s %10zu %12.0f %10.3f", name, size, bytes, flib );
+  if ( naive < 0.0 ) printf( " %10s", "-" );
+  else printf( " %10.3f", naive );
+  if ( blas < 0.0 ) printf( " %10s\n", "-" );
+  else printf( " %10.3f\n", blas );
+  fflush( stdout );
+}
+
+// time the statement over reps repetitions and return the minimum ticks per element over TRIALS trials
+#define MEASURE( result, reps, elements, statement ) { \
+  double best = DBL_MAX; \
+  for ( size_t trial = 0; trial < TRIALS; trial++ ) { \
+    const double t0 = TICKS( ); \
+    for ( size_t rep = 0; rep < ( reps ); rep++ ) { statement; } \
+    const double t1 = TICKS( ); \
+    if ( t1 - t0 < best ) best = t1 - t0; \
+  } \
+  result = best / ( ( double )( reps ) * ( elements ) ); \
+}
+
+static void vectors( const size_t n )
+{
+  double* a = getvector( n, 0.0 );
+  double* b = getvector( n, 0.0 );
+  double* w = getvector( n, 0.0 );
+  long seed = ( long )( n );
+  randomize( &seed );
+  for ( size_t i = 1; i <= n; i++ ) {
+    a[i] = nextdouble( );
+    b[i] = nextdouble( );
+    w[i] = nextdouble( );
+  }
+  const size_t reps = repetitions( ( double )( n ) );
+  const double bytes = 8.0 * n;
+  double tf = 0.0, tn = 0.0, tb = -1.0;
+
+  MEASURE( tf, reps, n, sink += ddot( n, &a[1], 1, &b[1], 1 ) );
+  MEASURE( tn, reps, n, sink += naivedot( n, &a[1], &b[1] ) );
+#ifdef FMDU_CBLAS
+  MEASURE( tb, reps, n, sink += cblas_ddot( ( int )( n ), &a[1], 1, &b[1], 1 ) );
+#endif
+  row( "ddot", n, 2.0 * bytes, tf, tn, tb );
+
+  MEASURE( tf, reps, n, sink += dwdot( n, &a[1], 1, &b[1], 1, &w[1], 1 ) );
+  MEASURE( tn, reps, n, sink += naivewdot( n, &a[1], &b[1], &w[1] ) );
+  row( "dwdot", n, 3.0 * bytes, tf, tn, -1.0 );
+
+  MEASURE( tf, reps, n, daxpy( n, 1.0e-9, &a[1], 1, &b[1], 1 ) );
+  MEASURE( tn, reps, n, naiveaxpy( n, 1.0e-9, &a[1], &b[1] ) );
+#ifdef FMDU_CBLAS
+  MEASURE( tb, reps, n, cblas_daxpy( ( int )( n ), 1.0e-9, &a[1], 1, &b[1], 1 ) );
+#endif
+  row( "daxpy", n, 2.0 * bytes, tf, tn, tb );
+
+  MEASURE( tf, reps, n, dscal( n, 1.0000001, &a[1], 1 ) );
+  MEASURE( tn, reps, n, naivescal( n, 0.9999999, &a[1] ) );
+#ifdef FMDU_CBLAS
+  MEASURE( tb, reps, n, cblas_dscal( ( int )( n ), 0.9999999, &a[1], 1 ) );
+#endif
+  row( "dscal", n, bytes, tf, tn, tb );
+
+  MEASURE( tf, reps, n, sink += dsum( n, &a[1], 1 ) );
+  MEASURE( tn, reps, n, sink += naivesum( n, &a[1] ) );
+  row( "dsum", n, bytes, tf, tn, -1.0 );
+
+  freevector( a );
+  freevector( b );
+  freevector( w );
+}
+
+static void matrices( const size_t n )
+{
+  double** a = getmatrix( n, n, 0.0 );
+  double** b = getmatrix( n, n, 0.0 );
+  double** c = getmatrix( n, n, 0.0 );
+  double* x = getvector( n, 0.0 );
+  double* y = getvector( n, 0.0 );
+  fill( n, n, a, ( long )( n ) );
+  fill( n, n, b, ( long )( n + 1 ) );
+  for ( size_t i = 1; i <= n; i++ ) x[i] = a[i][1];
+  const double nn = ( double )( n ) * ( double )( n );
+  const double nnn = nn * ( double )( n );
+  double tf = 0.0, tn = 0.0, tb = -1.0;
+
+  size_t reps = repetitions( nn );
+  MEASURE( tf, reps, nn, dgemv( false, n, n, 1.0, a, x, 0.0, y ) );
+  MEASURE( tn, reps, nn, naivegemv( n, a, x, y ) );
+#ifdef FMDU_CBLAS
+  MEASURE( tb, reps, nn, cblas_dgemv( CblasRowMajor, CblasNoTrans, ( int )( n ), ( int )( n ), 1.0, &a[1][1], ( int )( n ), &x[1], 1, 0.0, &y[1], 1 ) );
+#endif
+  row( "dgemv", n, 8.0 * nn, tf, tn, tb );
+
+  if ( n <= 512 ) {
+    reps = repetitions( nnn );
+    MEASURE( tf, reps, nnn, dgemm( false, false, n, n, n, 1.0, a, b, 0.0, c ) );
+    MEASURE( tn, reps, nnn, naivegemm( n, a, b, c ) );
+#ifdef FMDU_CBLAS
+    MEASURE( tb, reps, nnn, cblas_dgemm( CblasRowMajor, CblasNoTrans, CblasNoTrans, ( int )( n ), ( int )( n ), ( int )( n ), 1.0, &a[1][1], ( int )( n ), &b[1][1], ( int )( n ), 0.0, &c[1][1], ( int )( n ) ) );
+#endif
+    row( "dgemm", n, 24.0 * nn, tf, tn, tb );
+  }
+
+  sink += c[n][n] + y[n];
+  freematrix( a );
+  freematrix( b );
+  freematrix( c );
+  freevector( x );
+  freevector( y );
+}
+
+static void distances( const size_t n, const size_t p )
+{
+  double** a = getmatrix( n, p, 0.0 );
+  double** b = getmatrix( n, p, 0.0 );
+  double** r = getmatrix( n, n, 0.0 );
+  randomZ( n, p, a, ( long )( n ) );
+  randomZ( n, p, b, ( long )( n + 1 ) );
+  const double nn = ( double )( n ) * ( double )( n );
+  const size_t reps = repetitions( nn * p );
+  double tf = 0.0, tn = 0.0;
+  char name[32];
+
+  snprintf( name, sizeof( name ), "euclidean1/%zu", p );
+  MEASURE( tf, reps, nn, euclidean1( n, p, a, r ) );
+  MEASURE( tn, reps, nn, naiveeuclidean( n, p, a, n, a, r ) );
+  row( name, n, 8.0 * nn, tf, tn, -1.0 );
+
+  snprintf( name, sizeof( name ), "euclidean2/%zu", p );
+  MEASURE( tf, reps, nn, euclidean2( n, p, a, n, b, r ) );
+  MEASURE( tn, reps, nn, naiveeuclidean( n, p, a, n, b, r ) );
+  row( name, n, 8.0 * nn, tf, tn, -1.0 );
+
+  snprintf( name, sizeof( name ), "fdist/%zu", p );
+  MEASURE( tf, reps, nn, for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= n; j++ ) sink += fdist( p, &a[i][1], &b[j][1], 1 ) );
+  MEASURE( tn, reps, nn, for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= n; j++ ) sink += naivedist( p, &a[i][1], &b[j][1] ) );
+  row( name, n, 8.0 * nn, tf, tn, -1.0 );
+
+  freematrix( a );
+  freematrix( b );
+  freematrix( r );
+}
+
+static void decompositions( const size_t n )
+{
+  double** a = getmatrix( n, n, 0.0 );
+  double** s = getmatrix( n, n, 0.0 );
+  double** u = getmatrix( n, n, 0.0 );
+  double** v = getmatrix( n, n, 0.0 );
+  double* w = getvector( n, 0.0 );
+  fill( n, n, a, ( long )( n ) );
+  for ( size_t i = 1; i <= n; i++ ) a[i][i] += ( double )( n );
+  dgemm( true, false, n, n, n, 1.0, a, a, 0.0, s );
+  const double nnn = ( double )( n ) * ( double )( n ) * ( double )( n );
+  const size_t reps = repetitions( 10.0 * nnn );
+  double tf = 0.0, tn = 0.0;
+
+  MEASURE( tf, reps, nnn, dcopy( n * n, &a[1][1], 1, &u[1][1], 1 ); inverse( n, u ) );
+  MEASURE( tn, reps, nnn, dcopy( n * n, &a[1][1], 1, &u[1][1], 1 ); naiveinverse( n, u ) );
+  row( "inverse", n, 8.0 * n * n, tf, tn, -1.0 );
+
+  MEASURE( tf, reps, nnn, dcopy( n * n, &s[1][1], 1, &u[1][1], 1 ); evdcmp( n, u, w ) );
+  row( "evdcmp", n, 8.0 * n * n, tf, -1.0, -1.0 );
+
+  MEASURE( tf, reps, nnn, dcopy( n * n, &a[1][1], 1, &v[1][1], 1 ); svdcmp( n, n, v, u, w, s ) );
+  row( "svdcmp", n, 8.0 * n * n, tf, -1.0, -1.0 );
+
+  freematrix( a );
+  freematrix( s );
+  freematrix( u );
+  freematrix( v );
+  freevector( w );
+}
+
+static void sorting( const size_t n )
+{
+  double* a = getvector( n, 0.0 );
+  double* c = getvector( n, 0.0 );
+  size_t* r = getvector_t( n, 0 );
+  long seed = ( long )( n );
+  randomize( &seed );
+  for ( size_t i = 1; i <= n; i++ ) a[i] = nextdouble( );
+  const double elements = ( double )( n ) * log2( ( double )( n ) );
+  const size_t reps = repetitions( 4.0 * elements );
+  double tf = 0.0, tn = 0.0;
+
+  MEASURE( tf, reps, elements, dcopy( n, &a[1], 1, &c[1], 1 ); for ( size_t i = 1; i <= n; i++ ) r[i] = i; dsort( n, c, r ) );
+  MEASURE( tn, reps, elements, dcopy( n, &a[1], 1, &c[1], 1 ); qsort( &c[1], n, sizeof( double ), compare ) );
+  row( "dsort", n, 16.0 * n, tf, tn, -1.0 );
+
+  freevector( a );
+  freevector( c );
+  freevector_t( r );
+}
+
+int main( int argc, char** argv )
+{
+  const bool quick = ( argc > 1 && strcmp( argv[1], "quick" ) == 0 );
+
+  // working sets of about 8KB, 128KB, 2MB, and 64MB per vector or matrix
+  const size_t vsize[4] = { 1024, 16384, 262144, 8388608 };
+  const size_t msize[4] = { 32, 128, 512, 2896 };
+  const size_t dsize[4] = { 32, 128, 512, 2048 };
+  const size_t esize[3] = { 8, 32, 128 };
+  const size_t nsize = ( quick ? 2 : 4 );
+
+  printf( "%s per element, minimum of %d trials\n", TICKUNIT, TRIALS );
+  printf( "%-12s %10s %12s %10s %10s %10s\n", "primitive", "size", "bytes", "flib", "naive", "blas" );
+  for ( size_t k = 0; k < nsize; k++ ) vectors( vsize[k] );
+  for ( size_t k = 0; k < nsize; k++ ) matrices( msize[k] );
+  for ( size_t k = 0; k < nsize; k++ ) {
+    distances( dsize[k], 2 );
+    distances( dsize[k], 3 );
+  }
+  for ( size_t k = 0; k < ( quick ? 2 : 3 ); k++ ) decompositions( esize[k] );
+  for ( size_t k = 0; k < nsize; k++ ) sorting( vsize[k] );
+  return ( sink == 0.12345 );
+}
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include "fmdu.h"
+
+static double batchproblem( const size_t n, const size_t m, const double* rdelta, const double* rw, const size_t p, double* rx, double* ry, double* rd, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control )
+// Function batchproblem() runs one unfolding problem of a batch, input and output in R (column major) layout.
+// control holds the time budget and receives the status of the problem.
+{
+  // transfer to C
+  double** delta = getmatrix( n, m, 0.0 );
+  bool negative = false;
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) {
+    delta[i][j] = rdelta[k];
+    if ( rdelta[k] < 0.0 ) negative = true;
+  }
+  double** w = NULL;
+  if ( rw != NULL ) {
+    w = getmatrix( n, m, 0.0 );
+    for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) w[i][j] = rw[k];
+  }
+  double** x = getmatrix( n, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) x[i][j] = rx[k];
+  int** fx = getimatrix( n, p, 0 );
+  double** y = getmatrix( m, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) y[i][j] = ry[k];
+  int** fy = getimatrix( m, p, 0 );
+  double** d = getmatrix( n, m, 0.0 );
+
+  // run function
+  double fvalue = 0.0;
+  if ( w == NULL ) {
+    if ( negative == false ) fvalue = mdu( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, lastiter, lastdif, false, control, false );
+    else fvalue = mduneg( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, lastiter, lastdif, control, false );
+  }
+  else {
+    if ( negative == false ) fvalue = wgtmdu( n, m, delta, w, p, x, fx, y, fy, d, MAXITER, FCRIT, lastiter, lastdif, control, false );
+    else fvalue = wgtmduneg( n, m, delta, w, p, x, fx, y, fy, d, MAXITER, FCRIT, lastiter, lastdif, control, false );
+  }
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) ry[k] = y[i][j];
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
+
+  // de-allocate memory
+  freematrix( delta );
+  if ( w != NULL ) freematrix( w );
+  freematrix( x );
+  freeimatrix( fx );
+  freematrix( y );
+  freeimatrix( fy );
+  freematrix( d );
+
+  return fvalue;
+} // batchproblem
+
+void Cbatchmdu( int* rnproblems, int* rn, int* rm, double* rdelta, double* rw, int* rhasw, int* rp, double* rx, double* ry, double* rd, int* rmaxiter, double* rfdif, double* rfvalues, int* riters, double* rbudget, int* rstatus, int* rnthreads )
+// Function Cbatchmdu() performs multidimensional unfolding for a batch of independent problems.
+// Problem b has size rn[b] by rm[b]; delta, w, x, y, and d are packed one problem after the other, each in R layout.
+// Problems are distributed over the threads; each problem runs mdu(), mduneg(), wgtmdu(), or wgtmduneg().
+// All problems share the time budget from the start of the batch; rstatus receives the status per problem.
+{
+  // transfer to C
+  const size_t nproblems = *rnproblems;
+  const size_t p = *rp;
+  const size_t MAXITER = *rmaxiter;
+  const double FCRIT = *rfdif;
+  const bool hasw = ( *rhasw ) != 0;
+  const fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  // offsets of the packed problems
+  size_t* offnm = ( size_t* ) calloc( nproblems + 1, sizeof( size_t ) );
+  size_t* offx = ( size_t* ) calloc( nproblems + 1, sizeof( size_t ) );
+  size_t* offy = ( size_t* ) calloc( nproblems + 1, sizeof( size_t ) );
+  for ( size_t b = 0; b < nproblems; b++ ) {
+    offnm[b + 1] = offnm[b] + ( size_t )( rn[b] ) * ( size_t )( rm[b] );
+    offx[b + 1] = offx[b] + ( size_t )( rn[b] ) * p;
+    offy[b + 1] = offy[b] + ( size_t )( rm[b] ) * p;
+  }
+
+  // run problems
+#ifdef _OPENMP
+  const int nt = ( *rnthreads < 1 ? 1 : *rnthreads );
+  #pragma omp parallel for num_threads( nt ) schedule( dynamic, 1 ) if( nt > 1 )
+#endif
+  for ( size_t b = 0; b < nproblems; b++ ) {
+    size_t lastiter = 0;
+    double lastdif = 0.0;
+    fitcontrol problemcontrol = control;
+    rfvalues[b] = batchproblem( rn[b], rm[b], &rdelta[offnm[b]], ( hasw ? &rw[offnm[b]] : NULL ), p, &rx[offx[b]], &ry[offy[b]], &rd[offnm[b]], MAXITER, FCRIT, &lastiter, &lastdif, &problemcontrol );
+    riters[b] = ( int )( lastiter );
+    rstatus[b] = problemcontrol.status;
+  }
+
+  // de-allocate memory
+  free( offnm );
+  free( offx );
+  free( offy );
+
+} // Cbatchmdu
@@ -8,8 +8,44 @@
 
 #define IJ2K( n, i, j ) ( j * n + i )
 
-void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed )
+#if defined( __GNUC__ ) || defined( __clang__ )
+  #define PREFETCH( a ) __builtin_prefetch( a )
+#else
+  #define PREFETCH( a )
+#endif
+
+static const size_t DEFBLOCKSIZE = 128;  // 128 x 128 doubles of data, plus coordinates, stay within L2
+static const double TILERATE = 0.1;      // a tile visit grows beyond bn + bm updates once the learning rate drops below this
+static const size_t DEFBATCHSIZE = 32;   // pairs per mini-batch
+
+struct scheduletype_struct { int EXPONENTIAL; int COSINE; int PLATEAU; };
+static const struct scheduletype_struct SCHEDULE = { .EXPONENTIAL = 0, .COSINE = 1, .PLATEAU = 2 };
+
+static double nextrate( const int schedule, const size_t iter, const size_t NSTEPS, const double MAXRATE, const double RCRIT, const double ALPHA, const double mu, const double fsample, double* fbest, size_t* nstall )
+// learning rate for the next epoch
+// exponential: fixed decay from MAXRATE to RCRIT in NSTEPS epochs
+// cosine: cosine annealing from MAXRATE to RCRIT in NSTEPS epochs
+// plateau: halve the rate when the sampled stress of the epoch stops improving, stop below RCRIT
+{
+  const double PLATEAUTOL = 0.001;
+  const size_t PATIENCE = 8;
+  if ( schedule == SCHEDULE.COSINE ) return RCRIT + 0.5 * ( MAXRATE - RCRIT ) * ( 1.0 + cos( acos( -1.0 ) * ( double )( iter ) / ( double )( NSTEPS ) ) );
+  if ( schedule == SCHEDULE.PLATEAU ) {
+    if ( fsample < ( 1.0 - PLATEAUTOL ) * ( *fbest ) ) {
+      ( *fbest ) = fsample;
+      ( *nstall ) = 0;
+      return mu;
+    }
+    if ( ++( *nstall ) < PATIENCE ) return mu;
+    ( *nstall ) = 0;
+    return 0.5 * mu;
+  }
+  return mu * ALPHA;
+} // nextrate
+
+void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rstate, unsigned char* rrng, double* rbudget, int* rstatus )
 // function CRultrafastmdu() performs multidimensional unfolding
+// a resumed fit (firstiter > 0) continues from the learning rate state ( rate, best, stall ) and generator state of a checkpoint
 {
   // transfer to C
   const size_t n = *rn;
@@ -17,8 +53,10 @@ void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, doubl
   const size_t p = *rp;
   const size_t NSTEPS = *rnsteps;
   const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
   long xseed = ( long )( *rseed );
   randomize( &xseed );
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
 
   double* __restrict pdata = &rdata[0];
   double* __restrict px = &rx[0];
@@ -38,7 +76,17 @@ void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, doubl
   // start main loop
 	  
   double mu = MAXRATE;
-  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  if ( control.firstiter > 0 ) {
+    mu = rstate[0];
+    fbest = rstate[1];
+    nstall = ( size_t )( rstate[2] );
+    setrandomstate( rrng );
+  }
+  for ( size_t iter = firstiteration( &control ); iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
     const double cmu = 1.0 - mu;
 
     // start subsets loop
@@ -58,6 +106,8 @@ void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, doubl
       if ( d < TINY ) continue;
       const double delta = pdata[IJ2K( m, idy, idx )];
       const double b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
       for ( size_t k = 0; k < p; k++ ) {
         const double x = px[idxp + k];
         const double y = py[idyp + k];
@@ -67,13 +117,28 @@ void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, doubl
       }
     }
 
-    // exponentially decrease mu by alpha
-    mu *= ALPHA;
+    // decrease mu according to schedule
+    const double fsample = ( ssd > 0.0 ? ssr / ssd : 0.0 );
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, fsample, &fbest, &nstall );
+
+    // write checkpoint when due
+    if ( control.checkpoint != NULL && iter % control.interval == 0 ) {
+      const double state[5] = { ( double )( iter ), fsample, mu, fbest, ( double )( nstall ) };
+      unsigned char rng[CHECKPOINTRNGSIZE];
+      getrandomstate( rng );
+      writecheckpoint( control.checkpoint, state, n, m, p, px, py, 0, NULL, 0, NULL, rng );
+    }
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
   }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
 } // CRultrafastmdu
 		 
 
-void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed )
+void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
 // function CRultrafastmdufxd() performs multidimensional unfolding allowing anchors
 {
   // transfer to C
@@ -82,8 +147,10 @@ void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, in
   const size_t p = *rp;
   const size_t NSTEPS = *rnsteps;
   const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
   long xseed = ( long )( *rseed );
   randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
 
   double* __restrict pdata = &rdata[0];
 								 
@@ -102,7 +169,11 @@ void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, in
 
   // start main loop
   double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
   for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
     const double cmu = 1.0 - mu;
 
     // start subsets loop
@@ -119,6 +190,8 @@ void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, in
       if ( d < TINY ) continue;
       const double delta = pdata[IJ2K( m, idy, idx )];
       const double b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
       for ( size_t k = 0; k < p; k++ ) {
         const double x = px[idxp + k];
         const double y = py[idyp + k];
@@ -128,12 +201,18 @@ void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, in
       }
     }
 
-    // exponentially decrease mu by alpha
-    mu *= ALPHA;
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
   }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
 } // CRultrafastmdufxd
 
-void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed )
+void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
 // function CRultrafastwgtmdu() performs weighted multidimensional unfolding
 {
   // transfer to C
@@ -142,8 +221,10 @@ void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, doubl
   const size_t p = *rp;
   const size_t NSTEPS = *rnsteps;
   const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
   long xseed = ( long )( *rseed );
   randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
 
   double* __restrict pdata = &rdata[0];
   int* __restrict pw = &rw[0];
@@ -160,7 +241,11 @@ void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, doubl
 
   // start main loop
   double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
   for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
     const double cmu = 1.0 - mu;
 
     // start subsets loop
@@ -180,6 +265,8 @@ void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, doubl
       if ( d < TINY ) continue;
       const double delta = pdata[IJ2K( m, idy, idx )];
       const double b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
       for ( size_t k = 0; k < p; k++ ) {
         const double x = px[idxp + k];
         const double y = py[idyp + k];
@@ -189,12 +276,18 @@ void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, doubl
       }
     }
 
-    // exponentially decrease mu by alpha
-    mu *= ALPHA;
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
   }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
 } // CRultrafastwgtmdu
 
-void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed )
+void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
 // function CRultrafastwgtmdufxd() performs weighted multidimensional unfolding allowing anchors
 {
   // transfer to C
@@ -203,8 +296,10 @@ void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, do
   const size_t p = *rp;
   const size_t NSTEPS = *rnsteps;
   const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
   long xseed = ( long )( *rseed );
   randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
 
   double* __restrict pdata = &rdata[0];
   int* __restrict pw = &rw[0];
@@ -223,7 +318,11 @@ void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, do
 
   // start main loop
   double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
   for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
     const double cmu = 1.0 - mu;
 
     // start subsets loop
@@ -243,6 +342,8 @@ void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, do
       if ( d < TINY ) continue;
       const double delta = pdata[IJ2K( m, idy, idx )];
       const double b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
       for ( size_t k = 0; k < p; k++ ) {
         const double x = px[idxp + k];
         const double y = py[idyp + k];
@@ -252,12 +353,988 @@ void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, do
       }
     }
 
-    // exponentially decrease mu by alpha
-    mu *= ALPHA;
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
   }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
 } // CRultrafastwgtmdufxd
 
-void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed )
+void CRultrafastblkmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastblkmdu() performs multidimensional unfolding using a cache blocked sampling order
+// row and column tiles are visited in random order and pairs are drawn uniformly within the visited tile
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double MAXRATE = 0.5;
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // set tiles
+  const size_t BLOCKSIZE = ( *rblocksize > 0 ? ( size_t )( *rblocksize ) : DEFBLOCKSIZE );
+  const size_t bn = min_t( n, BLOCKSIZE );
+  const size_t bm = min_t( m, BLOCKSIZE );
+  const size_t nbx = ( n + bn - 1 ) / bn;
+  const size_t nby = ( m + bm - 1 ) / bm;
+  const size_t ntiles = nbx * nby;
+  size_t* perm = getvector_t( ntiles, 0 );
+  for ( size_t t = 1; t <= ntiles; t++ ) perm[t] = t - 1;
+  size_t tile = ntiles;
+  size_t x0 = 0;
+  size_t y0 = 0;
+  size_t xlen = 0;
+  size_t ylen = 0;
+  size_t left = 0;
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start tiles loop: as many updates as the unblocked engine, the tile order and an unfinished visit carry over
+    // a full tile visit has bn + bm updates, growing with TILERATE / mu up to one per tile cell, so that small steps reuse
+    // the tile's data from cache while large steps stay spread over many tiles, which keeps tiles from fitting on their own;
+    // partial edge tiles get their share of updates by area, rounded at random, so that all pairs are sampled equally often
+    const double cellrate = fmin( 1.0, fmax( 1.0, TILERATE / mu ) * ( double )( bn + bm ) / ( double )( bn * bm ) );
+    for ( size_t subs = 0; subs < NSUBSETS; ) {
+
+      // next pair of row and column tiles, every pair once before reshuffling
+      if ( left == 0 ) {
+        if ( tile == ntiles ) {
+          permutate_t( ntiles, perm );
+          tile = 0;
+        }
+        x0 = ( perm[++tile] / nby ) * bn;
+        y0 = ( perm[tile] % nby ) * bm;
+        xlen = min_t( bn, n - x0 );
+        ylen = min_t( bm, m - y0 );
+        left = ( size_t )( cellrate * ( double )( xlen * ylen ) + nextdouble( ) );
+        if ( left == 0 ) continue;
+      }
+      const size_t NUPDATES = min_t( left, NSUBSETS - subs );
+      left -= NUPDATES;
+
+      // first pair within tile
+      size_t idx = x0 + nextsize_t() % xlen;
+      size_t idy = y0 + nextsize_t() % ylen;
+
+      // start subsets loop within tile
+      for ( size_t u = 1; u <= NUPDATES; u++ ) {
+
+        // draw and prefetch next pair, while updating the current one
+        const size_t nidx = x0 + nextsize_t() % xlen;
+        const size_t nidy = y0 + nextsize_t() % ylen;
+        PREFETCH( &px[nidx * p] );
+        PREFETCH( &py[nidy * p] );
+        PREFETCH( &pdata[IJ2K( m, nidy, nidx )] );
+
+        const size_t idxp = idx * p;
+        const size_t idyp = idy * p;
+        const double delta = pdata[IJ2K( m, idy, idx )];
+        idx = nidx;
+        idy = nidy;
+
+        // update coordinates
+        const double d = fdist1( p, &px[idxp], &py[idyp] );
+        if ( d < TINY ) continue;
+        const double b = delta / d;
+        ssr += ( delta - d ) * ( delta - d );
+        ssd += delta * delta;
+        for ( size_t k = 0; k < p; k++ ) {
+          const double x = px[idxp + k];
+          const double y = py[idyp + k];
+          const double t = b * ( x - y );
+          px[idxp + k] = cmu * x + mu * ( t + y );
+          py[idyp + k] = cmu * y + mu * ( x - t );
+        }
+      }
+      subs += NUPDATES;
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+
+  freevector_t( perm );
+
+} // CRultrafastblkmdu
+
+void CRultrafastblkmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastblkmdufxd() performs multidimensional unfolding allowing anchors using a cache blocked sampling order
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+  int* __restrict pfx = &rfx[0];
+  int* __restrict pfy = &rfy[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double MAXRATE = 0.5;
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // set tiles
+  const size_t BLOCKSIZE = ( *rblocksize > 0 ? ( size_t )( *rblocksize ) : DEFBLOCKSIZE );
+  const size_t bn = min_t( n, BLOCKSIZE );
+  const size_t bm = min_t( m, BLOCKSIZE );
+  const size_t nbx = ( n + bn - 1 ) / bn;
+  const size_t nby = ( m + bm - 1 ) / bm;
+  const size_t ntiles = nbx * nby;
+  size_t* perm = getvector_t( ntiles, 0 );
+  for ( size_t t = 1; t <= ntiles; t++ ) perm[t] = t - 1;
+  size_t tile = ntiles;
+  size_t x0 = 0;
+  size_t y0 = 0;
+  size_t xlen = 0;
+  size_t ylen = 0;
+  size_t left = 0;
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start tiles loop: as many updates as the unblocked engine, the tile order and an unfinished visit carry over
+    // a full tile visit has bn + bm updates, growing with TILERATE / mu up to one per tile cell, so that small steps reuse
+    // the tile's data from cache while large steps stay spread over many tiles, which keeps tiles from fitting on their own;
+    // partial edge tiles get their share of updates by area, rounded at random, so that all pairs are sampled equally often
+    const double cellrate = fmin( 1.0, fmax( 1.0, TILERATE / mu ) * ( double )( bn + bm ) / ( double )( bn * bm ) );
+    for ( size_t subs = 0; subs < NSUBSETS; ) {
+
+      // next pair of row and column tiles, every pair once before reshuffling
+      if ( left == 0 ) {
+        if ( tile == ntiles ) {
+          permutate_t( ntiles, perm );
+          tile = 0;
+        }
+        x0 = ( perm[++tile] / nby ) * bn;
+        y0 = ( perm[tile] % nby ) * bm;
+        xlen = min_t( bn, n - x0 );
+        ylen = min_t( bm, m - y0 );
+        left = ( size_t )( cellrate * ( double )( xlen * ylen ) + nextdouble( ) );
+        if ( left == 0 ) continue;
+      }
+      const size_t NUPDATES = min_t( left, NSUBSETS - subs );
+      left -= NUPDATES;
+
+      // first pair within tile
+      size_t idx = x0 + nextsize_t() % xlen;
+      size_t idy = y0 + nextsize_t() % ylen;
+
+      // start subsets loop within tile
+      for ( size_t u = 1; u <= NUPDATES; u++ ) {
+
+        // draw and prefetch next pair, while updating the current one
+        const size_t nidx = x0 + nextsize_t() % xlen;
+        const size_t nidy = y0 + nextsize_t() % ylen;
+        PREFETCH( &px[nidx * p] );
+        PREFETCH( &py[nidy * p] );
+        PREFETCH( &pdata[IJ2K( m, nidy, nidx )] );
+
+        const size_t idxp = idx * p;
+        const size_t idyp = idy * p;
+        const double delta = pdata[IJ2K( m, idy, idx )];
+        idx = nidx;
+        idy = nidy;
+
+        // update coordinates
+        const double d = fdist1( p, &px[idxp], &py[idyp] );
+        if ( d < TINY ) continue;
+        const double b = delta / d;
+        ssr += ( delta - d ) * ( delta - d );
+        ssd += delta * delta;
+        for ( size_t k = 0; k < p; k++ ) {
+          const double x = px[idxp + k];
+          const double y = py[idyp + k];
+          const double t = b * ( x - y );
+          if ( pfx[idxp + k] == 0 ) px[idxp + k] = cmu * x + mu * ( t + y );
+          if ( pfy[idyp + k] == 0 ) py[idyp + k] = cmu * y + mu * ( x - t );
+        }
+      }
+      subs += NUPDATES;
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+
+  freevector_t( perm );
+
+} // CRultrafastblkmdufxd
+
+void CRultrafastbatmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rbatchsize, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastbatmdu() performs multidimensional unfolding using mini-batches of pairs
+// distances and ratios of a batch are computed lane-wise from the configuration at the start of the batch,
+// objects that occur more than once in a batch receive the average of their updates
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double MAXRATE = 0.5;
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+  const size_t B = ( *rbatchsize > 0 ? ( size_t )( *rbatchsize ) : DEFBATCHSIZE );
+  const size_t NBATCHES = ( NSUBSETS + B - 1 ) / B;
+
+  // allocate memory: batch lanes (dimension major) and occurrence counts
+  size_t* __restrict bx = ( size_t* ) calloc( B, sizeof( size_t ) );
+  size_t* __restrict by = ( size_t* ) calloc( B, sizeof( size_t ) );
+  double* __restrict xs = ( double* ) calloc( B * p, sizeof( double ) );
+  double* __restrict ys = ( double* ) calloc( B * p, sizeof( double ) );
+  double* __restrict ds = ( double* ) calloc( B, sizeof( double ) );
+  double* __restrict bs = ( double* ) calloc( B, sizeof( double ) );
+  size_t* __restrict cx = ( size_t* ) calloc( n, sizeof( size_t ) );
+  size_t* __restrict cy = ( size_t* ) calloc( m, sizeof( size_t ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+
+    // start batches loop
+    for ( size_t batch = 1; batch <= NBATCHES; batch++ ) {
+
+      // draw pairs and gather coordinates and data
+      for ( size_t l = 0; l < B; l++ ) {
+        const size_t idx = nextsize_t() % n;
+        const size_t idy = nextsize_t() % m;
+        bx[l] = idx;
+        by[l] = idy;
+        bs[l] = pdata[IJ2K( m, idy, idx )];
+        for ( size_t k = 0; k < p; k++ ) {
+          xs[k * B + l] = px[idx * p + k];
+          ys[k * B + l] = py[idy * p + k];
+        }
+      }
+
+      // distances and ratios over lanes
+      for ( size_t l = 0; l < B; l++ ) ds[l] = 0.0;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double* __restrict xk = &xs[k * B];
+        const double* __restrict yk = &ys[k * B];
+        for ( size_t l = 0; l < B; l++ ) {
+          const double diff = xk[l] - yk[l];
+          ds[l] += diff * diff;
+        }
+      }
+      for ( size_t l = 0; l < B; l++ ) {
+        const double d = sqrt( ds[l] );
+        if ( d < TINY ) bs[l] = 1.0;
+        else {
+          ssr += ( bs[l] - d ) * ( bs[l] - d );
+          ssd += bs[l] * bs[l];
+          bs[l] /= d;
+        }
+      }
+
+      // update steps over lanes: x + mu * ( b * ( x - y ) + y - x ) and y + mu * ( x - b * ( x - y ) - y )
+      for ( size_t k = 0; k < p; k++ ) {
+        double* __restrict xk = &xs[k * B];
+        double* __restrict yk = &ys[k * B];
+        for ( size_t l = 0; l < B; l++ ) {
+          const double t = ( bs[l] - 1.0 ) * ( xk[l] - yk[l] );
+          xk[l] = mu * t;
+          yk[l] = -1.0 * mu * t;
+        }
+      }
+
+      // count occurrences of objects within the batch
+      for ( size_t l = 0; l < B; l++ ) {
+        cx[bx[l]]++;
+        cy[by[l]]++;
+      }
+
+      // apply averaged steps
+      for ( size_t l = 0; l < B; l++ ) {
+        const size_t idxp = bx[l] * p;
+        const size_t idyp = by[l] * p;
+        const double fx = 1.0 / ( double )( cx[bx[l]] );
+        const double fy = 1.0 / ( double )( cy[by[l]] );
+        for ( size_t k = 0; k < p; k++ ) {
+          px[idxp + k] += fx * xs[k * B + l];
+          py[idyp + k] += fy * ys[k * B + l];
+        }
+      }
+      for ( size_t l = 0; l < B; l++ ) {
+        cx[bx[l]] = 0;
+        cy[by[l]] = 0;
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+
+  free( bx );
+  free( by );
+  free( xs );
+  free( ys );
+  free( ds );
+  free( bs );
+  free( cx );
+  free( cy );
+
+} // CRultrafastbatmdu
+
+void CRultrafastmduneg( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastmduneg() performs multidimensional unfolding allowing negative dissimilarities
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double DISCRIT = TINY;
+  const double EPSCRIT = 0.25 * TINY;
+  const double MAXRATE = 0.5;
+  const double MAXATTRACT = 0.45;  // largest rate of an attraction, such that a negative pair keeps a tenth of its distance
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start subsets loop
+    for( size_t subs = 1; subs <= NSUBSETS; subs++ ) {
+
+      // first and second indices
+      const size_t idx = nextsize_t() % n;
+      const size_t idy = nextsize_t() % m;
+      const size_t idxp = idx * p;
+      const size_t idyp = idy * p;
+
+      // update coordinates: negative dissimilarities attract with weight imw, based on Heiser (1989)
+      const double d = fdist1( p, &px[idxp], &py[idyp] );
+      const double delta = pdata[IJ2K( m, idy, idx )];
+      double b = 0.0;
+      double imw = 1.0;
+      if ( delta < 0.0 ) imw = ( d < DISCRIT ? ( EPSCRIT + delta * delta ) / EPSCRIT : ( d + fabs( delta ) ) / d );
+      else if ( d < TINY ) continue;
+      else b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
+      const double rmu = fmin( MAXATTRACT, mu * imw / ( cmu + mu * imw ) );
+      const double crmu = 1.0 - rmu;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double x = px[idxp + k];
+        const double y = py[idyp + k];
+        const double t = b * ( x - y );
+        px[idxp + k] = crmu * x + rmu * ( t + y );
+        py[idyp + k] = crmu * y + rmu * ( x - t );
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+} // CRultrafastmduneg
+
+void CRultrafastmdunegfxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastmdunegfxd() performs multidimensional unfolding allowing negative dissimilarities and anchors
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+								 
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+  int* __restrict pfx = &rfx[0];
+  int* __restrict pfy = &rfy[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double DISCRIT = TINY;
+  const double EPSCRIT = 0.25 * TINY;
+  const double MAXRATE = 0.5;
+  const double MAXATTRACT = 0.45;  // largest rate of an attraction, such that a negative pair keeps a tenth of its distance
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start subsets loop
+    for( size_t subs = 1; subs <= NSUBSETS; subs++ ) {
+
+      // first and second indices
+      const size_t idx = nextsize_t() % n;
+      const size_t idy = nextsize_t() % m;
+      const size_t idxp = idx * p;
+      const size_t idyp = idy * p;
+
+      // update coordinates: negative dissimilarities attract with weight imw, based on Heiser (1989)
+      const double d = fdist1( p, &px[idxp], &py[idyp] );
+      const double delta = pdata[IJ2K( m, idy, idx )];
+      double b = 0.0;
+      double imw = 1.0;
+      if ( delta < 0.0 ) imw = ( d < DISCRIT ? ( EPSCRIT + delta * delta ) / EPSCRIT : ( d + fabs( delta ) ) / d );
+      else if ( d < TINY ) continue;
+      else b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
+      const double rmu = fmin( MAXATTRACT, mu * imw / ( cmu + mu * imw ) );
+      const double crmu = 1.0 - rmu;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double x = px[idxp + k];
+        const double y = py[idyp + k];
+        const double t = b * ( x - y );
+        if ( pfx[idxp + k] == 0 ) px[idxp + k] = crmu * x + rmu * ( t + y );
+        if ( pfy[idyp + k] == 0 ) py[idyp + k] = crmu * y + rmu * ( x - t );
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+} // CRultrafastmdunegfxd
+
+void CRultrafastwgtmduneg( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastwgtmduneg() performs weighted multidimensional unfolding allowing negative dissimilarities
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  int* __restrict pw = &rw[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double DISCRIT = TINY;
+  const double EPSCRIT = 0.25 * TINY;
+  const double MAXRATE = 0.5;
+  const double MAXATTRACT = 0.45;  // largest rate of an attraction, such that a negative pair keeps a tenth of its distance
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start subsets loop
+    for( size_t subs = 1; subs <= NSUBSETS; subs++ ) {
+
+      // first and second indices
+      const size_t idx = nextsize_t() % n;
+      const size_t idy = nextsize_t() % m;
+
+      if ( pw[IJ2K( m, idy, idx )] == 0 ) continue;
+
+      const size_t idxp = idx * p;
+      const size_t idyp = idy * p;
+
+      // update coordinates: negative dissimilarities attract with weight imw, based on Heiser (1989)
+      const double d = fdist1( p, &px[idxp], &py[idyp] );
+      const double delta = pdata[IJ2K( m, idy, idx )];
+      double b = 0.0;
+      double imw = 1.0;
+      if ( delta < 0.0 ) imw = ( d < DISCRIT ? ( EPSCRIT + delta * delta ) / EPSCRIT : ( d + fabs( delta ) ) / d );
+      else if ( d < TINY ) continue;
+      else b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
+      const double rmu = fmin( MAXATTRACT, mu * imw / ( cmu + mu * imw ) );
+      const double crmu = 1.0 - rmu;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double x = px[idxp + k];
+        const double y = py[idyp + k];
+        const double t = b * ( x - y );
+        px[idxp + k] = crmu * x + rmu * ( t + y );
+        py[idyp + k] = crmu * y + rmu * ( x - t );
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+} // CRultrafastwgtmduneg
+
+void CRultrafastwgtmdunegfxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
+// function CRultrafastwgtmdunegfxd() performs weighted multidimensional unfolding allowing negative dissimilarities and anchors
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const size_t NSTEPS = *rnsteps;
+  const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
+  long xseed = ( long )( *rseed );
+  randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  double* __restrict pdata = &rdata[0];
+  int* __restrict pw = &rw[0];
+  double* __restrict px = &rx[0];
+  double* __restrict py = &ry[0];
+  int* __restrict pfx = &rfx[0];
+  int* __restrict pfy = &rfy[0];
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double DISCRIT = TINY;
+  const double EPSCRIT = 0.25 * TINY;
+  const double MAXRATE = 0.5;
+  const double MAXATTRACT = 0.45;  // largest rate of an attraction, such that a negative pair keeps a tenth of its distance
+  const size_t NSUBSETS = n + m;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start subsets loop
+    for( size_t subs = 1; subs <= NSUBSETS; subs++ ) {
+
+      // first and second indices
+      const size_t idx = nextsize_t() % n;
+      const size_t idy = nextsize_t() % m;
+
+      if ( pw[IJ2K( m, idy, idx )] == 0 ) continue;
+
+      const size_t idxp = idx * p;
+      const size_t idyp = idy * p;
+
+      // update coordinates: negative dissimilarities attract with weight imw, based on Heiser (1989)
+      const double d = fdist1( p, &px[idxp], &py[idyp] );
+      const double delta = pdata[IJ2K( m, idy, idx )];
+      double b = 0.0;
+      double imw = 1.0;
+      if ( delta < 0.0 ) imw = ( d < DISCRIT ? ( EPSCRIT + delta * delta ) / EPSCRIT : ( d + fabs( delta ) ) / d );
+      else if ( d < TINY ) continue;
+      else b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
+      const double rmu = fmin( MAXATTRACT, mu * imw / ( cmu + mu * imw ) );
+      const double crmu = 1.0 - rmu;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double x = px[idxp + k];
+        const double y = py[idyp + k];
+        const double t = b * ( x - y );
+        if ( pfx[idxp + k] == 0 ) px[idxp + k] = crmu * x + rmu * ( t + y );
+        if ( pfy[idyp + k] == 0 ) py[idyp + k] = crmu * y + rmu * ( x - t );
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
+} // CRultrafastwgtmdunegfxd
+
+static int ultrafastmduupd( const size_t n, const size_t m, const size_t stride, const double* __restrict pdata, const int* __restrict pw, const size_t p, double* __restrict px, const int* __restrict pfr, double* __restrict py, const int* __restrict pfc, const bool freeze, const size_t NSTEPS, const double RCRIT, long seed, const int schedule, const double budget )
+// function ultrafastmduupd() refreshes a (weighted) multidimensional unfolding solution for focused rows and columns
+// every pair has at least one focused endpoint, the partner is drawn at random from the other set
+// with freeze, only focused objects move, as with anchors in CRultrafastmdufxd()
+// data and weights are row major with row stride stride, negative dissimilarities attract as in CRultrafastmduneg()
+{
+  randomize( &seed );
+  fitcontrol control = setcontrol( NULL, 0, 0, budget );
+
+  // focus list: rows as 0..n-1, columns as n..n+m-1
+  size_t nfocus = 0;
+  for ( size_t i = 0; i < n; i++ ) if ( pfr[i] != 0 ) nfocus++;
+  for ( size_t j = 0; j < m; j++ ) if ( pfc[j] != 0 ) nfocus++;
+  if ( nfocus == 0 ) {
+    setstatus( &control, true, false );
+    return control.status;
+  }
+  size_t* __restrict focus = ( size_t* ) calloc( nfocus, sizeof( size_t ) );
+  size_t f = 0;
+  for ( size_t i = 0; i < n; i++ ) if ( pfr[i] != 0 ) focus[f++] = i;
+  for ( size_t j = 0; j < m; j++ ) if ( pfc[j] != 0 ) focus[f++] = n + j;
+
+  // set constants
+  const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+  const double DISCRIT = TINY;
+  const double EPSCRIT = 0.25 * TINY;
+  const double MAXRATE = 0.5;
+  const double MAXATTRACT = 0.45;  // largest rate of an attraction, such that a negative pair keeps a tenth of its distance
+  const size_t NSUBSETS = nfocus;
+  const double ALPHA = pow( RCRIT / MAXRATE, 1.0 / ( double )( NSTEPS ) );
+
+  // start main loop
+  double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
+  for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
+    const double cmu = 1.0 - mu;
+
+    // start subsets loop
+    for( size_t subs = 1; subs <= NSUBSETS; subs++ ) {
+
+      // focused object and random partner
+      const size_t obj = focus[nextsize_t() % nfocus];
+      const size_t idx = ( obj < n ? obj : nextsize_t() % n );
+      const size_t idy = ( obj < n ? nextsize_t() % m : obj - n );
+
+      if ( pw[IJ2K( stride, idy, idx )] == 0 ) continue;
+
+      const size_t idxp = idx * p;
+      const size_t idyp = idy * p;
+      const bool movex = ( !freeze || pfr[idx] != 0 );
+      const bool movey = ( !freeze || pfc[idy] != 0 );
+
+      // update coordinates: negative dissimilarities attract with weight imw, based on Heiser (1989)
+      const double d = fdist1( p, &px[idxp], &py[idyp] );
+      const double delta = pdata[IJ2K( stride, idy, idx )];
+      double b = 0.0;
+      double rmu = mu;
+      if ( delta < 0.0 ) {
+        const double imw = ( d < DISCRIT ? ( EPSCRIT + delta * delta ) / EPSCRIT : ( d + fabs( delta ) ) / d );
+        rmu = fmin( MAXATTRACT, mu * imw / ( cmu + mu * imw ) );
+      }
+      else if ( d < TINY ) continue;
+      else b = delta / d;
+      ssr += ( delta - d ) * ( delta - d );
+      ssd += delta * delta;
+      const double crmu = 1.0 - rmu;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double x = px[idxp + k];
+        const double y = py[idyp + k];
+        const double t = b * ( x - y );
+        if ( movex ) px[idxp + k] = crmu * x + rmu * ( t + y );
+        if ( movey ) py[idyp + k] = crmu * y + rmu * ( x - t );
+      }
+    }
+
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
+  }
+  setstatus( &control, mu < RCRIT, false );
+
+  // de-allocate memory
+  free( focus );
+
+  return control.status;
+
+} // ultrafastmduupd
+
+// online unfolding: the data and weights of an onlinemdu object are kept in C memory, row major with spare rows
+// and columns, such that appending k rows or columns costs O(km) amortized and a refresh only transfers coordinates;
+// objects are kept in a registry (see registry.h) and identified by a handle { id, token }, as designs and scorers
+
+typedef struct online_struct {
+  size_t n;          // number of rows
+  size_t m;          // number of columns
+  size_t ncap;       // allocated rows
+  size_t mcap;       // allocated columns, the row stride
+  double* data;      // ncap x mcap dissimilarities
+  int* w;            // ncap x mcap, nonzero for present cells
+} online;
+
+static registry onlines;
+
+static online* getonline( const int* handle, const size_t n, const size_t m )
+// returns the online data with handle { id, token } and size n by m, or NULL for an invalid or outdated handle
+{
+  online* o = ( online* ) gethandle( &onlines, handle );
+  if ( o == NULL || o->n != n || o->m != m ) return NULL;
+  return o;
+} // getonline
+
+static void freeonline( online* o )
+// releases the data and weights of o and o itself
+{
+  free( o->data );
+  free( o->w );
+  free( o );
+} // freeonline
+
+static bool reserve( online* o, const size_t n, const size_t m )
+// grows the capacity of o to at least n by m, at least doubling a dimension that grows
+{
+  if ( n <= o->ncap && m <= o->mcap ) return true;
+  const size_t ncap = ( n <= o->ncap ? o->ncap : max_t( n, 2 * o->ncap ) );
+  const size_t mcap = ( m <= o->mcap ? o->mcap : max_t( m, 2 * o->mcap ) );
+  double* data = ( double* ) calloc( ncap * mcap, sizeof( double ) );
+  int* w = ( int* ) calloc( ncap * mcap, sizeof( int ) );
+  if ( data == NULL || w == NULL ) {
+    free( data );
+    free( w );
+    return false;
+  }
+  for ( size_t i = 0; i < o->n; i++ ) {
+    memcpy( &data[i * mcap], &o->data[i * o->mcap], o->m * sizeof( double ) );
+    memcpy( &w[i * mcap], &o->w[i * o->mcap], o->m * sizeof( int ) );
+  }
+  free( o->data );
+  free( o->w );
+  o->data = data;
+  o->w = w;
+  o->ncap = ncap;
+  o->mcap = mcap;
+  return true;
+} // reserve
+
+void CRnewonline( int* rn, int* rm, double* rdata, int* rw, int* rhandle )
+// function CRnewonline() stores the row major n by m data and weights and returns the handle { id, token }, or { -1, 0 }
+{
+  const size_t n = *rn;
+  const size_t m = *rm;
+  rhandle[0] = -1;
+  rhandle[1] = 0;
+  online* o = ( online* ) calloc( 1, sizeof( online ) );
+  if ( o == NULL ) return;
+  if ( !reserve( o, n, m ) ) {
+    free( o );
+    return;
+  }
+  memcpy( o->data, rdata, n * m * sizeof( double ) );
+  memcpy( o->w, rw, n * m * sizeof( int ) );
+  o->n = n;
+  o->m = m;
+  if ( newhandle( &onlines, o, rhandle ) != 0 ) freeonline( o );
+} // CRnewonline
+
+void CRonlineaddrows( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus )
+// function CRonlineaddrows() appends k row major rows of data and weights, status -1 for an invalid handle and -2 without memory
+{
+  online* o = getonline( rhandle, ( size_t )( *rn ), ( size_t )( *rm ) );
+  if ( o == NULL ) {
+    ( *rstatus ) = -1;
+    return;
+  }
+  const size_t k = *rk;
+  if ( !reserve( o, o->n + k, o->m ) ) {
+    ( *rstatus ) = -2;
+    return;
+  }
+  for ( size_t i = 0; i < k; i++ ) {
+    memcpy( &o->data[( o->n + i ) * o->mcap], &rdata[i * o->m], o->m * sizeof( double ) );
+    memcpy( &o->w[( o->n + i ) * o->mcap], &rw[i * o->m], o->m * sizeof( int ) );
+  }
+  o->n += k;
+  ( *rstatus ) = 0;
+} // CRonlineaddrows
+
+void CRonlineaddcols( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus )
+// function CRonlineaddcols() appends k columns given as row major n by k data and weights, status as CRonlineaddrows()
+{
+  online* o = getonline( rhandle, ( size_t )( *rn ), ( size_t )( *rm ) );
+  if ( o == NULL ) {
+    ( *rstatus ) = -1;
+    return;
+  }
+  const size_t k = *rk;
+  if ( !reserve( o, o->n, o->m + k ) ) {
+    ( *rstatus ) = -2;
+    return;
+  }
+  for ( size_t i = 0; i < o->n; i++ ) {
+    memcpy( &o->data[i * o->mcap + o->m], &rdata[i * k], k * sizeof( double ) );
+    memcpy( &o->w[i * o->mcap + o->m], &rw[i * k], k * sizeof( int ) );
+  }
+  o->m += k;
+  ( *rstatus ) = 0;
+} // CRonlineaddcols
+
+void CRonlinesetcells( int* rhandle, int* rn, int* rm, int* rk, int* ri, int* rj, double* rvalue, int* rw, int* rstatus )
+// function CRonlinesetcells() changes k cells with one-based row and column indices, status -1 for an invalid handle or index
+{
+  online* o = getonline( rhandle, ( size_t )( *rn ), ( size_t )( *rm ) );
+  const size_t k = *rk;
+  ( *rstatus ) = -1;
+  if ( o == NULL ) return;
+  for ( size_t l = 0; l < k; l++ ) if ( ri[l] < 1 || ( size_t )( ri[l] ) > o->n || rj[l] < 1 || ( size_t )( rj[l] ) > o->m ) return;
+  for ( size_t l = 0; l < k; l++ ) {
+    const size_t c = ( size_t )( ri[l] - 1 ) * o->mcap + ( size_t )( rj[l] - 1 );
+    o->data[c] = rvalue[l];
+    o->w[c] = rw[l];
+  }
+  ( *rstatus ) = 0;
+} // CRonlinesetcells
+
+void CRonlinerefresh( int* rhandle, int* rn, int* rm, int* rp, double* rx, int* rfr, double* ry, int* rfc, int* rfreeze, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
+// function CRonlinerefresh() refreshes the row major coordinates for the focused rows and columns, status -1 for an invalid handle
+{
+  online* o = getonline( rhandle, ( size_t )( *rn ), ( size_t )( *rm ) );
+  if ( o == NULL ) {
+    ( *rstatus ) = -1;
+    return;
+  }
+  ( *rstatus ) = ultrafastmduupd( o->n, o->m, o->mcap, o->data, o->w, ( size_t )( *rp ), rx, rfr, ry, rfc, ( *rfreeze != 0 ), ( size_t )( *rnsteps ), *rminrate, ( long )( *rseed ), *rschedule, *rbudget );
+} // CRonlinerefresh
+
+void CRfreeonline( int* rhandle )
+// function CRfreeonline() releases the online data with handle { id, token }, an invalid handle is ignored
+{
+  online* o = ( online* ) releasehandle( &onlines, rhandle );
+  if ( o != NULL ) freeonline( o );
+} // CRfreeonline
+
+void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus )
 // function CRultrafastmdu() performs multidimensional unfolding
 {
   // transfer to C
@@ -266,8 +1343,10 @@ void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, doub
   const size_t p = *rp;
   const size_t NSTEPS = *rnsteps;
   const double RCRIT = *rminrate;
+  const int schedule = *rschedule;
   long xseed = ( long )( *rseed );
   randomize( &xseed );
+  fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
 
   double* __restrict pdata = &rdata[0];
   double* __restrict px = &rx[0];
@@ -283,7 +1362,11 @@ void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, doub
 
   // start main loop
   double mu = MAXRATE;
+  double fbest = DBL_MAX;
+  size_t nstall = 0;
   for ( size_t iter = 1; iter <= NSTEPS; iter++ ) {
+    double ssr = 0.0;
+    double ssd = 0.0;
     const double cmu = 1.0 - mu;
 
     // start subsets loop
@@ -323,6 +1406,8 @@ void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, doub
       const double p2 = b21 + b22;
       const double q1 = b11 + b21;
       const double q2 = b12 + b22;
+      ssr += ( delta11 - d11 ) * ( delta11 - d11 ) + ( delta12 - d12 ) * ( delta12 - d12 ) + ( delta21 - d21 ) * ( delta21 - d21 ) + ( delta22 - d22 ) * ( delta22 - d22 );
+      ssd += delta11 * delta11 + delta12 * delta12 + delta21 * delta21 + delta22 * delta22;
       for ( size_t k = 0; k < p; k++ ) {
         const double x1 = px[idxp1 + k];
         const double x2 = px[idxp2 + k];
@@ -335,9 +1420,15 @@ void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, doub
       }
     }
 
-    // exponentially decrease mu by alpha
-    mu *= ALPHA;
+    // decrease mu according to schedule
+    mu = nextrate( schedule, iter, NSTEPS, MAXRATE, RCRIT, ALPHA, mu, ( ssd > 0.0 ? ssr / ssd : 0.0 ), &fbest, &nstall );
+    if ( mu < RCRIT ) break;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( &control ) ) break;
   }
+  setstatus( &control, mu < RCRIT, false );
+  ( *rstatus ) = control.status;
 } // CRultrafastmdu2
 
 void CRultrafastrowresmdu( int* rn, int* rm, double* rdata, int* rp, int* rh, double* rq, double* rb, double* ry, int* rnsteps, double* rminrate, int* rseed )
@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double colresmduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double colresmduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function colresmduneg() performs column restricted multidimensional unfolding allowing negative dissimilarities.
 {
   const double EPS = DBL_EPSILON;                                            // 2.2204460492503131e-16
@@ -52,12 +52,13 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute original B and W matrices, based on Heiser (1989)
     for ( size_t i = 1; i <= n; i++ ) {
@@ -78,6 +79,7 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
       for ( size_t i = 1; i <= n; i++ ) work += imw[i][j];
       wc[j] = work;
     }
+    PROFILESTOP( control, PHASE.BMATRIX, 4.0 * n * m, 32.0 * n * m );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -98,6 +100,7 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update x
     for ( size_t k = 1; k <= p; k++ ) {
@@ -133,6 +136,7 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
 
     // update y
     dgemm( false, false, m, p, h, 1.0, q, b, 0.0, y );
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
     euclidean2( n, p, x, m, y, d );
@@ -144,9 +148,10 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
       }
     }
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -154,8 +159,15 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, 0, NULL, h, b );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   if ( nfx == 0 ) rotateplus( n, p, x, h, b );
@@ -175,7 +187,7 @@ double colresmduneg( const size_t n, const size_t m, double** delta, const size_
   return( fnew );
 } // colresmduneg
 
-void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Ccolresmduneg() performs column restricted multidimensional unfolding allowing negative dissimilarities.
 {
   // transfer to C
@@ -197,11 +209,13 @@ void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int*
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = colresmduneg( n, m, delta, p, x, fx, h, q, b, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = colresmduneg( n, m, delta, p, x, fx, h, q, b, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
@@ -211,6 +225,9 @@ void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int*
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function colreswgtmdu() performs row restricted weighted multidimensional unfolding.
 {
   const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
@@ -58,28 +58,17 @@ double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w,
 
   // update distances and calculate normalized stress
   dgemm( false, false, m, p, h, 1.0, q, b, 0.0, y );
-  euclidean2( n, p, x, m, y, d );
-  double fold = 0.0;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      const double work = delta[i][j] - d[i][j];
-      fold += w[i][j] * work * work;
-    }
-  }
+  double fold = fusedstress( n, p, x, m, y, delta, w, TINY, d, imb );
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute B matrix
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : w[i][j] * delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -100,6 +89,7 @@ double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w,
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update x
     dgemm( false, false, m, p, n, 1.0, w, y, 0.0, hnp );
@@ -120,20 +110,15 @@ double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w,
 
     // update y
     dgemm( false, false, m, p, h, 1.0, q, b, 0.0, y );
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
-    fnew = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += w[i][j] * work * work;
-      }
-    }
+    fnew = fusedstress( n, p, x, m, y, delta, w, TINY, d, imb );
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -141,8 +126,15 @@ double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w,
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, 0, NULL, h, b );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   if ( nfx == 0 ) rotateplus( n, p, x, h, b );
@@ -162,7 +154,7 @@ double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w,
   return( fnew );
 } // colreswgtmdu
 
-void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Ccolreswgtmdu() performs row restricted weighted multidimensional unfolding.
 {
   // transfer to C
@@ -186,11 +178,13 @@ void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, doubl
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = colreswgtmdu( n, m, delta, w, p, x, fx, h, q, b, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = colreswgtmdu( n, m, delta, w, p, x, fx, h, q, b, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
@@ -200,6 +194,9 @@ void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, doubl
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "control.h"
+#include "flib.h"
+
+fitcontrol setcontrol( const char* checkpoint, const int interval, const int firstiter, const double budget )
+// Function setcontrol() returns the controls for one fit, starting its clock;
+// an empty checkpoint name or a zero interval disables checkpoints, a zero budget disables the time budget.
+{
+  fitcontrol control;
+  control.checkpoint = ( checkpoint == NULL || checkpoint[0] == '\0' || interval <= 0 ? NULL : checkpoint );
+  control.interval = ( interval > 0 ? ( size_t )( interval ) : 0 );
+  control.firstiter = ( firstiter > 0 ? ( size_t )( firstiter ) : 0 );
+  control.budget = ( budget > 0.0 ? budget : 0.0 );
+  control.starttime = setstarttime( );
+  control.status = STATUS.MAXITER;
+  control.trace = NULL;
+  control.tracesize = 0;
+  control.ntrace = 0;
+  control.echointerval = 1;
+  control.tracetime = control.starttime;
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) control.profile[k] = 0.0;
+  return control;
+} // setcontrol
+
+size_t firstiteration( const fitcontrol* control )
+// Function firstiteration() returns the number of the first iteration of a fresh or resumed fit.
+{
+  return ( control == NULL ? 1 : control->firstiter + 1 );
+} // firstiteration
+
+bool outoftime( fitcontrol* control )
+// Function outoftime() returns true, and sets the status, when the time budget of the fit is exhausted.
+{
+  if ( control == NULL || control->budget == 0.0 ) return false;
+  if ( getelapsedtime( control->starttime ) < control->budget ) return false;
+  control->status = STATUS.BUDGET;
+  return true;
+} // outoftime
+
+void setstatus( fitcontrol* control, const bool stopped, const bool diverged )
+// Function setstatus() sets the final status of a fit that was not stopped by its time budget:
+// stopped before the maximum number of iterations is either converged or diverged.
+{
+  if ( control == NULL || control->status == STATUS.BUDGET ) return;
+  if ( stopped == false ) control->status = STATUS.MAXITER;
+  else control->status = ( diverged ? STATUS.DIVERGED : STATUS.CONVERGED );
+} // setstatus
+
+void settrace( fitcontrol* control, double* trace, const int tracesize, const int echointerval )
+// Function settrace() attaches a trace buffer of tracesize rows, zero for no trace, and sets the echo interval.
+{
+  control->trace = ( trace == NULL || tracesize <= 0 ? NULL : trace );
+  control->tracesize = ( control->trace == NULL ? 0 : ( size_t )( tracesize ) );
+  control->ntrace = 0;
+  control->echointerval = ( echointerval > 1 ? ( size_t )( echointerval ) : 1 );
+} // settrace
+
+void traceiteration( fitcontrol* control, const bool echo, const size_t iter, const double fold, const double fnew, const size_t n, const size_t m, double** d, const double tiny )
+// Function traceiteration() records iteration iter in the trace buffer while there is room, and echoes it when due.
+// Only a trace counts the distances below tiny, such that a fit without trace does no extra work.
+{
+  if ( control == NULL ) {
+    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    return;
+  }
+  if ( control->ntrace < control->tracesize ) {
+    const uint64_t now = setstarttime( );
+    size_t nzero = 0;
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t j = 1; j <= m; j++ ) nzero += ( d[i][j] < tiny );
+    const size_t rows = control->tracesize;
+    double* row = &control->trace[control->ntrace];
+    row[0] = ( double )( iter );
+    row[rows] = fnew;
+    row[2 * rows] = fold - fnew;
+    row[3 * rows] = ( double )( now - control->tracetime ) * 1.0e-9;
+    row[4 * rows] = ( double )( nzero );
+    control->ntrace++;
+    control->tracetime = setstarttime( );
+  }
+  if ( echo == true && iter % control->echointerval == 0 ) echoprogress( iter, fold, fold, fnew );
+} // traceiteration
+
+void profilephase( fitcontrol* control, const int phase, const double flops, const double bytes, uint64_t* time )
+// Function profilephase() ends a phase that started at time, adding its seconds and counts, and starts the next phase.
+{
+  const uint64_t now = setstarttime( );
+  if ( control != NULL ) {
+    control->profile[phase] += ( double )( now - ( *time ) ) * 1.0e-9;
+    control->profile[PROFILEPHASES + phase] += flops;
+    control->profile[2 * PROFILEPHASES + phase] += bytes;
+  }
+  ( *time ) = now;
+} // profilephase
+
+static bool writeblock( FILE* file, const size_t n, const size_t p, const double* a )
+{
+  if ( n == 0 || p == 0 || a == NULL ) return true;
+  return fwrite( a, sizeof( double ), n * p, file ) == n * p;
+} // writeblock
+
+bool writecheckpoint( const char* path, const double* state, const size_t n, const size_t m, const size_t p, const double* x, const double* y, const size_t hx, const double* bx, const size_t hy, const double* by, const unsigned char* rng )
+// Function writecheckpoint() writes a checkpoint file; state holds iteration, function value, rate, best, and stall.
+// Matrices are contiguous and row major; rng may be NULL for deterministic fits.
+{
+  if ( path == NULL ) return false;
+  const size_t length = strlen( path );
+  char* temp = ( char* ) malloc( length + 5 );
+  if ( temp == NULL ) return false;
+  memcpy( temp, path, length );
+  memcpy( temp + length, ".tmp", 5 );
+
+  FILE* file = fopen( temp, "wb" );
+  if ( file == NULL ) {
+    free( temp );
+    return false;
+  }
+  double header[10];
+  for ( size_t k = 0; k < 5; k++ ) header[k] = state[k];
+  header[5] = ( double )( n );
+  header[6] = ( double )( m );
+  header[7] = ( double )( p );
+  header[8] = ( double )( bx == NULL ? 0 : hx );
+  header[9] = ( double )( by == NULL ? 0 : hy );
+  unsigned char zeros[CHECKPOINTRNGSIZE] = { 0 };
+  bool ok = fwrite( CHECKPOINTMAGIC, 1, 8, file ) == 8;
+  ok = ok && fwrite( header, sizeof( double ), 10, file ) == 10;
+  ok = ok && fwrite( ( rng == NULL ? zeros : rng ), 1, CHECKPOINTRNGSIZE, file ) == CHECKPOINTRNGSIZE;
+  ok = ok && writeblock( file, n, p, x );
+  ok = ok && writeblock( file, m, p, y );
+  ok = ok && writeblock( file, ( bx == NULL ? 0 : hx ), p, bx );
+  ok = ok && writeblock( file, ( by == NULL ? 0 : hy ), p, by );
+  ok = ( fclose( file ) == 0 ) && ok;
+
+  // replace the previous checkpoint only by a complete one
+  if ( ok ) {
+    #ifdef _WIN32
+      remove( path );
+    #endif
+    ok = rename( temp, path ) == 0;
+  }
+  else remove( temp );
+  free( temp );
+  return ok;
+} // writecheckpoint
+
+void checkpoint( const fitcontrol* control, const size_t iter, const double fvalue, const size_t n, const size_t m, const size_t p, double** x, double** y, const size_t hx, double** bx, const size_t hy, double** by )
+// Function checkpoint() writes the state of a deterministic kernel after iteration iter when a checkpoint is due.
+// Matrices are 1-based with contiguous rows, as allocated by getmatrix().
+{
+  if ( control == NULL || control->checkpoint == NULL ) return;
+  if ( iter % control->interval != 0 ) return;
+  const double state[5] = { ( double )( iter ), fvalue, 0.0, 0.0, 0.0 };
+  writecheckpoint( control->checkpoint, state, n, m, p, &x[1][1], &y[1][1], hx, ( bx == NULL ? NULL : &bx[1][1] ), hy, ( by == NULL ? NULL : &by[1][1] ), NULL );
+} // checkpoint
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// fitcontrol: run-time controls shared by the unfolding kernels, a NULL control disables all of them
+// Checkpoints hold the state of a fit after a completed iteration: iteration, function value, learning rate state,
+// coordinates, coefficients, and random number generator state. A fit restarted from this state with firstiter set
+// to the checkpointed iteration repeats the iterations of the original fit. The file layout is
+//   8 bytes magic, 10 doubles header ( iter, fvalue, rate, best, stall, n, m, p, hx, hy ), 32 bytes generator state,
+//   followed by x (n by p), y (m by p), bx (hx by p), and by (hy by p), all row major.
+// Files are written to a temporary name first and renamed, such that an interrupted write keeps the previous checkpoint.
+// A time budget stops a fit after the first iteration (epoch for the stochastic kernels) that ends beyond the budget,
+// returning the configuration of that iteration; status tells why a fit stopped. For the majorization kernels this is
+// the best configuration so far, as their stress does not increase, but not necessarily for the stochastic kernels.
+// Batch and external fits share one budget from the start of the call and report a status per problem or object.
+// A trace buffer of tracesize rows holds, column major, per iteration: iteration, stress, stress decrease,
+// seconds spent in the iteration, and the number of distances below TINY; echo prints every echointerval-th row.
+// Compiled with FMDU_PROFILE, the kernels accumulate per phase the elapsed seconds and model estimates of the
+// floating point operations and bytes moved by the dominant loops; without it the profile macros do nothing and only
+// reference the flop estimate, which the compiler discards, such that counters kept for the estimates stay in use.
+
+#define CHECKPOINTMAGIC "FMDUCKP1"
+#define CHECKPOINTRNGSIZE 32
+#define TRACECOLUMNS 5
+#define PROFILEPHASES 5
+
+struct statustype_struct { int CONVERGED; int MAXITER; int BUDGET; int DIVERGED; };
+static const struct statustype_struct STATUS = { .CONVERGED = 0, .MAXITER = 1, .BUDGET = 2, .DIVERGED = 3 };
+
+struct phasetype_struct { int BMATRIX; int TILDE; int UPDATE; int DISTANCE; int SOLVE; };
+static const struct phasetype_struct PHASE = { .BMATRIX = 0, .TILDE = 1, .UPDATE = 2, .DISTANCE = 3, .SOLVE = 4 };
+
+typedef struct fitcontrol_struct {
+  const char* checkpoint;  // checkpoint file name, NULL for no checkpoints
+  size_t interval;         // number of iterations between checkpoints
+  size_t firstiter;        // number of iterations completed before a resumed fit, 0 for a fresh start
+  double budget;           // time budget in seconds, 0 for no budget
+  uint64_t starttime;      // start of the fit on the monotonic clock
+  int status;              // reason for stopping, one of STATUS
+  double* trace;           // trace buffer ( tracesize by TRACECOLUMNS ), NULL for no trace
+  size_t tracesize;        // number of rows in the trace buffer
+  size_t ntrace;           // number of rows recorded
+  size_t echointerval;     // number of iterations between echoed rows
+  uint64_t tracetime;      // end of the previously recorded iteration on the monotonic clock
+  double profile[3 * PROFILEPHASES];  // seconds, flops, and bytes per phase ( PROFILEPHASES by 3 ), column major
+} fitcontrol;
+
+#ifdef FMDU_PROFILE
+  #define PROFILESTART( ) uint64_t profiletime = setstarttime( )
+  #define PROFILESTOP( control, phase, flops, bytes ) profilephase( control, phase, flops, bytes, &profiletime )
+#else
+  #define PROFILESTART( )
+  #define PROFILESTOP( control, phase, flops, bytes ) ( void )( flops )
+#endif
+
+extern fitcontrol setcontrol( const char* checkpoint, const int interval, const int firstiter, const double budget );
+extern size_t firstiteration( const fitcontrol* control );
+extern bool outoftime( fitcontrol* control );
+extern void setstatus( fitcontrol* control, const bool stopped, const bool diverged );
+extern void settrace( fitcontrol* control, double* trace, const int tracesize, const int echointerval );
+extern void traceiteration( fitcontrol* control, const bool echo, const size_t iter, const double fold, const double fnew, const size_t n, const size_t m, double** d, const double tiny );
+extern void profilephase( fitcontrol* control, const int phase, const double flops, const double bytes, uint64_t* time );
+extern bool writecheckpoint( const char* path, const double* state, const size_t n, const size_t m, const size_t p, const double* x, const double* y, const size_t hx, const double* bx, const size_t hy, const double* by, const unsigned char* rng );
+extern void checkpoint( const fitcontrol* control, const size_t iter, const double fvalue, const size_t n, const size_t m, const size_t p, double** x, double** y, const size_t hx, double** bx, const size_t hy, double** by );
+
+#endif
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include "design.h"
+#include "registry.h"
+
+design* newdesign( const size_t n, const size_t h, double** q )
+// Function newdesign() creates a design for the n by h matrix q.
+{
+  if ( n == 0 || h == 0 || q == NULL ) return NULL;
+  design* dq = ( design* ) calloc( 1, sizeof( design ) );
+  if ( dq == NULL ) return NULL;
+  dq->n = n;
+  dq->h = h;
+  dq->q = getmatrix( n, h, 0.0 );
+  dq->cross = getmatrix( h, h, 0.0 );
+  dq->inv = getmatrix( h, h, 0.0 );
+  dq->sums = getvector( h, 0.0 );
+  for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= h; k++ ) dq->q[i][k] = q[i][k];
+
+  // cross-product matrix by row-wise rank one updates of the upper triangle, its inverse, and column sums
+  for ( size_t k = 1; k <= n; k++ ) {
+    const double* qk = &q[k][0];
+    for ( size_t i = 1; i <= h; i++ ) {
+      const double work = qk[i];
+      if ( work == 0.0 ) continue;
+      double* gi = &dq->cross[i][0];
+      for ( size_t j = i; j <= h; j++ ) gi[j] += work * qk[j];
+    }
+  }
+  for ( size_t i = 2; i <= h; i++ ) for ( size_t j = 1; j < i; j++ ) dq->cross[i][j] = dq->cross[j][i];
+  for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= h; j++ ) dq->inv[i][j] = dq->cross[i][j];
+  inverse( h, dq->inv );
+  for ( size_t k = 1; k <= h; k++ ) {
+    double work = 0.0;
+    for ( size_t i = 1; i <= n; i++ ) work += q[i][k];
+    dq->sums[k] = work;
+  }
+  return dq;
+} // newdesign
+
+void freedesign( design* dq )
+// Function freedesign() releases a design.
+{
+  if ( dq == NULL ) return;
+  freematrix( dq->q );
+  freematrix( dq->cross );
+  freematrix( dq->inv );
+  freevector( dq->sums );
+  free( dq );
+} // freedesign
+
+// R interface: designs are kept in a registry (see registry.h) and identified by a handle { id, token }
+
+static registry designs;
+
+design* getdesign( const int* handle )
+// Function getdesign() returns the design with handle { id, token }, or NULL for an unused or stale handle.
+{
+  return ( design* ) gethandle( &designs, handle );
+} // getdesign
+
+void CRnewdesign( int* rn, int* rh, double* rq, int* rhandle )
+// Function CRnewdesign() creates a design from the column major n by h matrix q and returns its handle { id, token }, or { -1, 0 }.
+{
+  rhandle[0] = -1;
+  rhandle[1] = 0;
+  const size_t n = ( size_t )( *rn );
+  const size_t h = ( size_t )( *rh );
+  double** q = getmatrix( n, h, 0.0 );
+  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
+  design* dq = newdesign( n, h, q );
+  freematrix( q );
+  if ( dq == NULL ) return;
+  if ( newhandle( &designs, dq, rhandle ) != 0 ) freedesign( dq );
+} // CRnewdesign
+
+void CRfreedesign( int* rhandle )
+// Function CRfreedesign() releases the design with handle { id, token }, a stale handle is ignored.
+{
+  design* dq = ( design* ) releasehandle( &designs, rhandle );
+  if ( dq != NULL ) freedesign( dq );
+} // CRfreedesign
@@ -0,0 +1,31 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#ifndef DESIGN_H
+#define DESIGN_H
+
+#include "flib.h"
+
+// design: persistent restriction handle for a fixed matrix of independent variables
+// the matrix q is copied once, together with its cross-product matrix q'q, the inverse of q'q, and its column sums,
+// which is everything the unweighted (penalized) restricted kernels derive from q before their first iteration.
+// A design only depends on q, not on the dissimilarities, and can be shared by any number of consecutive fits,
+// as the kernels do not modify it.
+
+typedef struct design_struct {
+  size_t n;          // number of objects
+  size_t h;          // number of independent variables
+  double** q;        // n x h independent variables
+  double** cross;    // h x h cross-product matrix q'q
+  double** inv;      // h x h inverse of q'q
+  double* sums;      // h, column sums of q
+} design;
+
+extern design* newdesign( const size_t n, const size_t h, double** q );
+extern design* getdesign( const int* handle );
+extern void freedesign( design* dq );
+
+#endif
@@ -17,117 +17,148 @@ static void pdist( const size_t n, double* d, double* r )
   dscal( n, 1.0 / alpha, &r[1], 1 );
 } // pdist
 
-double external( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** fixed, double** z, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
-// Function external() performs external unfolding.
+static double externalobject( const size_t i, const size_t m, double** delta, double** w, const size_t p, double** fixed, const double* ft, const double* fn, double** z, double** d, const size_t MAXITER, const double FCRIT, double* fw, double* b, double* dwork, double* probs, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
+// Function externalobject() performs external unfolding for object i, using scratch vectors fw (weighted sums), b, dwork, and probs.
+// control holds the time budget and receives the status of the object.
+// ft holds fixed dimension major (p by m, 0-based) and fn the squared norms of the fixed points.
 {
   const double EPS = DBL_EPSILON;   // 2.2204460492503131e-16
   const double TOL = sqrt( EPS );   // 1.4901161193847656e-08
   const double CRIT = sqrt( TOL );  // 0.00012207031250000000
 
-  // allocate memory
-  double* b = getvector( m, 0.0 );
-  double* dwork = getvector( m, 0.0 );
-  double fvalue = 0.0;
+  // work with temporary delta
+  for ( size_t j = 1; j <= m; j++ ) dwork[j] = delta[i][j];
 
-  // loop over objects (one at the time)
-  for ( size_t i = 1; i <= n; i++ ) {
+  // init variables
+  const double sumw = dsum( m, &w[i][1], 1 );
+  const double scale = dwssq( m, &dwork[1], 1, &w[i][1], 1 );
+  for ( size_t k = 1; k <= p; k++ ) fw[k] = ddot( m, &w[i][1], 1, &ft[( k - 1 ) * m], 1 );
 
-    // work with temporary delta
-    for ( size_t j = 1; j <= m; j++ ) dwork[j] = delta[i][j];
-
-    // init variables
-    const double sumw = dsum( m, &w[i][1], 1 );
-    const double scale = dwssq( m, &dwork[1], 1, &w[i][1], 1 );
-
-    // initial z: probability weighted average
-    if ( iszero( dssq( p, &z[i][1], 1 ) ) ) {
-      double* probs = getvector( m, 0.0 );
-      pdist( m, dwork, probs );
-      for ( size_t k = 1; k <= p; k++ ) {
-        double work = 0.0;
-        for ( size_t j = 1; j <= m; j++ ) work += probs[j] * fixed[j][k];
-        z[i][k] = work;
-      }
-      freevector( probs );
+  // initial z: probability weighted average
+  if ( iszero( dssq( p, &z[i][1], 1 ) ) ) {
+    pdist( m, dwork, probs );
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t j = 1; j <= m; j++ ) work += probs[j] * fixed[j][k];
+      z[i][k] = work;
     }
+  }
+
+  // administration: distances
+  normdistances( p, &z[i][1], dssq( p, &z[i][1], 1 ), m, ft, m, fn, &d[i][1] );
+
+  // administration: function value
+  double fold = wrmse( m, &dwork[1], 1, &d[i][1], 1, &w[i][1], 1 );
+  fold /= scale;
+  double fnew = 0.0;
 
-    // administration: distances
-    for ( size_t j = 1; j <= m; j++ ) {
-      double sum = 0.0;
-      for ( size_t k = 1; k <= p; k++ ) {
-        const double diff = z[i][k] - fixed[j][k];
-        if ( diff != 0.0 ) sum += diff * diff;
-      }
-      d[i][j] = sqrt( sum );
+  // echo intermediate results
+  if ( echo == true ) echoprogress( 0, 1.0, 1.0, fold );
+
+  // algorithm loop
+  size_t iter = 0;
+  for ( iter = 1; iter <= MAXITER; iter++ ) {
+
+    // scale delta
+    const double lower = dwssq( m, &dwork[1], 1, &w[i][1], 1 );
+    const double upper = ddot( m, &dwork[1], 1, &d[i][1], 1 );
+    const double alpha = ( lower < DBL_EPSILON ? 1.0 : upper / lower );
+    dscal( m, alpha, &dwork[1], 1 );
+
+    // update configuration
+    for ( size_t j = 1; j <= m; j++ ) b[j] = ( isnotzero( d[i][j] ) ? w[i][j] * dwork[j] / d[i][j] : 0.0 );
+
+    // update: xtilde
+    const double pi = dsum( m, &b[1], 1 );
+    for ( size_t k = 1; k <= p; k++ ) {
+      const double by = ddot( m, &b[1], 1, &ft[( k - 1 ) * m], 1 );
+      z[i][k] = ( pi * z[i][k] - by + fw[k] ) / sumw;
     }
 
-    // administration: function value
-    double fold = wrmse( m, &dwork[1], 1, &d[i][1], 1, &w[i][1], 1 );
-    fold /= scale;
-    double fnew = 0.0;
+    // administration
+    normdistances( p, &z[i][1], dssq( p, &z[i][1], 1 ), m, ft, m, fn, &d[i][1] );
+    fnew = wrmse( m, &dwork[1], 1, &d[i][1], 1, &w[i][1], 1 );
+    fnew /= scale;
 
     // echo intermediate results
-    if ( echo == true ) echoprogress( 0, 1.0, 1.0, fold );
-
-    // algorithm loop
-    size_t iter = 0;
-    for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-      // scale delta
-      const double lower = dwssq( m, &dwork[1], 1, &w[i][1], 1 );
-      const double upper = ddot( m, &dwork[1], 1, &d[i][1], 1 );
-      const double alpha = ( lower < DBL_EPSILON ? 1.0 : upper / lower );
-      dscal( m, alpha, &dwork[1], 1 );
-
-      // update configuration
-      for ( size_t j = 1; j <= m; j++ ) b[j] = ( isnotzero( d[i][j] ) ? w[i][j] * dwork[j] / d[i][j] : 0.0 );
-
-      // update: xtilde
-      const double pi = dsum( m, &b[1], 1 );
-      for ( size_t k = 1; k <= p; k++ ) {
-        const double by = ddot( m, &b[1], 1, &fixed[1][k], p );
-        double xtilde = pi * z[i][k] - by;
-        for ( size_t j = 1; j <= m; j++ ) xtilde += w[i][j] * fixed[j][k];
-        z[i][k] = xtilde / sumw;
-      }
-
-      // administration
-      for ( size_t j = 1; j <= m; j++ ) {
-        double sum = 0.0;
-        for ( size_t k = 1; k <= p; k++ ) {
-          const double diff = z[i][k] - fixed[j][k];
-          if ( diff != 0.0 ) sum += diff * diff;
-        }
-        d[i][j] = sqrt( sum );
-      }
-      fnew = wrmse( m, &dwork[1], 1, &d[i][1], 1, &w[i][1], 1 );
-      fnew /= scale;
-
-      // echo intermediate results
-      if ( echo == true ) echoprogress( iter, fold, fold, fnew );
-
-      // check divergence and convergence
-      ( *lastdif ) = fold - fnew;
-      if ( ( *lastdif ) <= -1.0 * CRIT ) break;
-      const double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
-      if ( fdif <= FCRIT ) break;
-      fold = fnew;
-    }
-    ( *lastiter ) += iter;
-    fvalue += fnew;
+    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+
+    // check divergence and convergence
+    lastdif[i] = fold - fnew;
+    if ( lastdif[i] <= -1.0 * CRIT ) break;
+    const double fdif = 2.0 * lastdif[i] / ( fold + fnew );
+    if ( fdif <= FCRIT ) break;
+    fold = fnew;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
+  lastiter[i] = ( iter > MAXITER ? MAXITER : iter );
+  setstatus( control, iter <= MAXITER, lastdif[i] <= -1.0 * CRIT );
 
-  // de-allocate memory
-  freevector( b );
-  freevector( dwork );
+  // return function value
+  return fnew;
+
+} // externalobject
+
+double external( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** fixed, double** z, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const fitcontrol* control, int* status, const bool echo, const size_t nthreads )
+// Function external() performs external unfolding.
+// Objects are independent given fixed and are distributed over nthreads threads, each with its own scratch vectors.
+// lastiter and lastdif receive the number of iterations and the final function difference per object.
+// All objects share the time budget of control, which may be NULL, from its start; status (1-based, may be NULL) receives the status per object.
+{
+#ifdef _OPENMP
+  const int nt = ( int )( nthreads < 1 ? 1 : nthreads );
+  const bool echoobject = ( echo == true && nt == 1 );
+#else
+  const bool echoobject = echo;
+#endif
+  double fvalue = 0.0;
+
+  // fixed dimension major with squared norms, shared by all objects
+  double* ft = ( double* ) calloc( p * m, sizeof( double ) );
+  double* fn = ( double* ) calloc( m, sizeof( double ) );
+  for ( size_t j = 1; j <= m; j++ ) {
+    for ( size_t k = 1; k <= p; k++ ) ft[( k - 1 ) * m + j - 1] = fixed[j][k];
+    fn[j - 1] = dssq( p, &fixed[j][1], 1 );
+  }
+
+  // loop over objects (one at the time), in parallel if available
+#ifdef _OPENMP
+  #pragma omp parallel num_threads( nt ) reduction( +:fvalue ) if( nt > 1 )
+#endif
+  {
+    // allocate memory
+    double* fw = getvector( p, 0.0 );
+    double* b = getvector( m, 0.0 );
+    double* dwork = getvector( m, 0.0 );
+    double* probs = getvector( m, 0.0 );
+
+#ifdef _OPENMP
+    #pragma omp for schedule( dynamic, 16 )
+#endif
+    for ( size_t i = 1; i <= n; i++ ) {
+      fitcontrol objectcontrol = ( control == NULL ? setcontrol( NULL, 0, 0, 0.0 ) : *control );
+      fvalue += externalobject( i, m, delta, w, p, fixed, ft, fn, z, d, MAXITER, FCRIT, fw, b, dwork, probs, lastiter, lastdif, &objectcontrol, echoobject );
+      if ( status != NULL ) status[i] = objectcontrol.status;
+    }
+
+    // de-allocate memory
+    freevector( fw );
+    freevector( b );
+    freevector( dwork );
+    freevector( probs );
+  }
+  free( ft );
+  free( fn );
 
   // return function value
   return fvalue;
 
 } // external
 
-void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
-// Function Cexternal() performs external unfolding.
+void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* riters, double* rbudget, int* rstatus, int* rnthreads, int* recho )
+// Function Cexternal() performs external unfolding, rstatus receives the status per object.
 {
   // transfer to C
   const size_t n = *rn;
@@ -144,18 +175,27 @@ void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* r
   double** d = getmatrix( n, m, 0.0 );
   const size_t MAXITER = *rmaxiter;
   const double FCRIT = *rfdif;
+  const size_t nthreads = ( *rnthreads < 1 ? 1 : ( size_t )( *rnthreads ) );
   bool echo = ( *recho ) != 0;
+  const fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
 
   // run function
-  size_t lastiter = 0;
-  double lastdif = 0.0;
-  const double fvalue = external( n, m, delta, w, p, fixed, z, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  size_t* lastiter = getvector_t( n, 0 );
+  double* lastdif = getvector( n, 0.0 );
+  int* status = getivector( n, 0 );
+  const double fvalue = external( n, m, delta, w, p, fixed, z, d, MAXITER, FCRIT, lastiter, lastdif, &control, status, echo, nthreads );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rz[k] = z[i][j];
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
-  ( *rmaxiter ) = ( int ) ( lastiter );
-  ( *rfdif ) = lastdif;
+  size_t maxiter = 0;
+  for ( size_t i = 1; i <= n; i++ ) {
+    riters[i - 1] = ( int ) ( lastiter[i] );
+    rstatus[i - 1] = status[i];
+    if ( lastiter[i] > maxiter ) maxiter = lastiter[i];
+  }
+  ( *rmaxiter ) = ( int ) ( maxiter );
+  ( *rfdif ) = lastdif[n];
   ( *rfvalue ) = fvalue;
 
   // de-allocate memory
@@ -164,5 +204,203 @@ void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* r
   freematrix( fixed );
   freematrix( z );
   freematrix( d );
+  freevector_t( lastiter );
+  freevector( lastdif );
+  freeivector( status );
 
 } // Cexternal
+
+static double sparseobject( const size_t nnz, const size_t* cols, const double* delta, const double* w, const size_t p, const double* ft, const size_t m, const double* fn, double* z, double* d, const size_t MAXITER, const double FCRIT, double* fg, double* gn, double* fw, double* b, double* dwork, double* probs, size_t* lastiter, double* lastdif, fitcontrol* control )
+// Function sparseobject() performs external unfolding for one object with nnz observed columns cols (0-based).
+// The observed fixed points are gathered dimension major in fg (p by nnz) with squared norms gn and weighted sums fw; z is 0-based,
+// d, b, dwork, and probs are 1-based; all work is O( nnz * p ) per iteration. control holds the time budget and receives the status.
+{
+  const double EPS = DBL_EPSILON;   // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );   // 1.4901161193847656e-08
+  const double CRIT = sqrt( TOL );  // 0.00012207031250000000
+
+  // gather observed fixed points and work with temporary delta
+  for ( size_t l = 0; l < nnz; l++ ) {
+    for ( size_t k = 0; k < p; k++ ) fg[k * nnz + l] = ft[k * m + cols[l]];
+    gn[l] = fn[cols[l]];
+    dwork[l + 1] = delta[l];
+  }
+
+  // init variables
+  const double sumw = dsum( nnz, w, 1 );
+  const double scale = dwssq( nnz, &dwork[1], 1, w, 1 );
+  for ( size_t k = 0; k < p; k++ ) fw[k] = ddot( nnz, w, 1, &fg[k * nnz], 1 );
+
+  // initial z: probability weighted average over the observed columns
+  if ( iszero( dssq( p, z, 1 ) ) ) {
+    pdist( nnz, dwork, probs );
+    for ( size_t k = 0; k < p; k++ ) z[k] = ddot( nnz, &probs[1], 1, &fg[k * nnz], 1 );
+  }
+
+  // administration: distances and function value
+  normdistances( p, z, dssq( p, z, 1 ), nnz, fg, nnz, gn, &d[1] );
+  double fold = wrmse( nnz, &dwork[1], 1, &d[1], 1, w, 1 );
+  fold /= scale;
+  double fnew = 0.0;
+
+  // algorithm loop
+  size_t iter = 0;
+  for ( iter = 1; iter <= MAXITER; iter++ ) {
+
+    // scale delta
+    const double lower = dwssq( nnz, &dwork[1], 1, w, 1 );
+    const double upper = ddot( nnz, &dwork[1], 1, &d[1], 1 );
+    const double alpha = ( lower < DBL_EPSILON ? 1.0 : upper / lower );
+    dscal( nnz, alpha, &dwork[1], 1 );
+
+    // update configuration
+    for ( size_t l = 1; l <= nnz; l++ ) b[l] = ( isnotzero( d[l] ) ? w[l - 1] * dwork[l] / d[l] : 0.0 );
+
+    // update: xtilde
+    const double pi = dsum( nnz, &b[1], 1 );
+    for ( size_t k = 0; k < p; k++ ) {
+      const double by = ddot( nnz, &b[1], 1, &fg[k * nnz], 1 );
+      z[k] = ( pi * z[k] - by + fw[k] ) / sumw;
+    }
+
+    // administration
+    normdistances( p, z, dssq( p, z, 1 ), nnz, fg, nnz, gn, &d[1] );
+    fnew = wrmse( nnz, &dwork[1], 1, &d[1], 1, w, 1 );
+    fnew /= scale;
+
+    // check divergence and convergence
+    ( *lastdif ) = fold - fnew;
+    if ( ( *lastdif ) <= -1.0 * CRIT ) break;
+    const double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
+    if ( fdif <= FCRIT ) break;
+    fold = fnew;
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
+  }
+  ( *lastiter ) = ( iter > MAXITER ? MAXITER : iter );
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
+
+  // return function value
+  return fnew;
+
+} // sparseobject
+
+double spexternal( const size_t n, const size_t m, const size_t* rowptr, const size_t* cols, const double* delta, const double* w, const size_t p, double** fixed, double** z, double* d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const fitcontrol* control, int* status, const size_t nthreads )
+// Function spexternal() performs external unfolding with sparse rows:
+// object i observes columns cols[rowptr[i-1]..rowptr[i]) (0-based) with dissimilarities delta and weights w,
+// d receives the distances of the observed pairs, lastiter, lastdif, and status (may be NULL) the per object results (1-based),
+// as in external().
+{
+#ifdef _OPENMP
+  const int nt = ( int )( nthreads < 1 ? 1 : nthreads );
+#endif
+  double fvalue = 0.0;
+
+  // fixed dimension major with squared norms, shared by all objects
+  double* ft = ( double* ) calloc( p * m, sizeof( double ) );
+  double* fn = ( double* ) calloc( m, sizeof( double ) );
+  for ( size_t j = 1; j <= m; j++ ) {
+    for ( size_t k = 1; k <= p; k++ ) ft[( k - 1 ) * m + j - 1] = fixed[j][k];
+    fn[j - 1] = dssq( p, &fixed[j][1], 1 );
+  }
+  size_t maxnnz = 1;
+  for ( size_t i = 1; i <= n; i++ ) maxnnz = max_t( maxnnz, rowptr[i] - rowptr[i - 1] );
+
+  // loop over objects (one at the time), in parallel if available
+#ifdef _OPENMP
+  #pragma omp parallel num_threads( nt ) reduction( +:fvalue ) if( nt > 1 )
+#endif
+  {
+    // allocate memory
+    double* fg = ( double* ) calloc( p * maxnnz, sizeof( double ) );
+    double* gn = ( double* ) calloc( maxnnz, sizeof( double ) );
+    double* fw = ( double* ) calloc( p, sizeof( double ) );
+    double* b = getvector( maxnnz, 0.0 );
+    double* dwork = getvector( maxnnz, 0.0 );
+    double* probs = getvector( maxnnz, 0.0 );
+    double* dd = getvector( maxnnz, 0.0 );
+
+#ifdef _OPENMP
+    #pragma omp for schedule( dynamic, 64 )
+#endif
+    for ( size_t i = 1; i <= n; i++ ) {
+      const size_t lo = rowptr[i - 1];
+      const size_t nnz = rowptr[i] - lo;
+      lastiter[i] = 0;
+      lastdif[i] = 0.0;
+      if ( status != NULL ) status[i] = STATUS.CONVERGED;
+      if ( nnz == 0 ) continue;
+      fitcontrol objectcontrol = ( control == NULL ? setcontrol( NULL, 0, 0, 0.0 ) : *control );
+      fvalue += sparseobject( nnz, &cols[lo], &delta[lo], &w[lo], p, ft, m, fn, &z[i][1], dd, MAXITER, FCRIT, fg, gn, fw, b, dwork, probs, &lastiter[i], &lastdif[i], &objectcontrol );
+      if ( status != NULL ) status[i] = objectcontrol.status;
+      for ( size_t l = 0; l < nnz; l++ ) d[lo + l] = dd[l + 1];
+    }
+
+    // de-allocate memory
+    free( fg );
+    free( gn );
+    free( fw );
+    freevector( b );
+    freevector( dwork );
+    freevector( probs );
+    freevector( dd );
+  }
+  free( ft );
+  free( fn );
+
+  // return function value
+  return fvalue;
+
+} // spexternal
+
+void Cspexternal( int* rn, int* rm, int* rrowptr, int* rcols, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* riters, double* rbudget, int* rstatus, int* rnthreads )
+// Function Cspexternal() performs external unfolding with sparse rows (compressed row storage, 0-based pointers and columns),
+// rstatus receives the status per object.
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  size_t* rowptr = ( size_t* ) calloc( n + 1, sizeof( size_t ) );
+  for ( size_t i = 0; i <= n; i++ ) rowptr[i] = ( size_t )( rrowptr[i] );
+  const size_t nnz = rowptr[n];
+  size_t* cols = ( size_t* ) calloc( nnz + 1, sizeof( size_t ) );
+  for ( size_t l = 0; l < nnz; l++ ) cols[l] = ( size_t )( rcols[l] );
+  double** fixed = getmatrix( m, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) fixed[i][j] = rfixed[k];
+  double** z = getmatrix( n, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) z[i][j] = rz[k];
+  const size_t MAXITER = *rmaxiter;
+  const double FCRIT = *rfdif;
+  const size_t nthreads = ( *rnthreads < 1 ? 1 : ( size_t )( *rnthreads ) );
+  const fitcontrol control = setcontrol( NULL, 0, 0, *rbudget );
+
+  // run function
+  size_t* lastiter = getvector_t( n, 0 );
+  double* lastdif = getvector( n, 0.0 );
+  int* status = getivector( n, 0 );
+  const double fvalue = spexternal( n, m, rowptr, cols, rdelta, rw, p, fixed, z, rd, MAXITER, FCRIT, lastiter, lastdif, &control, status, nthreads );
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rz[k] = z[i][j];
+  size_t maxiter = 0;
+  for ( size_t i = 1; i <= n; i++ ) {
+    riters[i - 1] = ( int ) ( lastiter[i] );
+    rstatus[i - 1] = status[i];
+    if ( lastiter[i] > maxiter ) maxiter = lastiter[i];
+  }
+  ( *rmaxiter ) = ( int ) ( maxiter );
+  ( *rfdif ) = lastdif[n];
+  ( *rfvalue ) = fvalue;
+
+  // de-allocate memory
+  free( rowptr );
+  free( cols );
+  freematrix( fixed );
+  freematrix( z );
+  freevector_t( lastiter );
+  freevector( lastdif );
+  freeivector( status );
+
+} // Cspexternal
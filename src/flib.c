@@ -8,6 +8,21 @@
 #include <math.h>
 
 #ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOGDI
+  #include <windows.h>
+#endif
+
+// bounds checked functions of the standalone build, mapped to their posix counterparts outside windows
+#if !defined( R ) && !defined( _WIN32 )
+  static int fopen_s( FILE** file, const char* name, const char* mode )
+  {
+    ( *file ) = fopen( name, mode );
+    return ( ( *file ) == NULL );
+  }
+  #define strtok_s strtok_r
+  #define strcpy_s( dst, size, src ) strcpy( dst, src )
+  #define printf_s printf
 #endif
 
 // -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -174,6 +189,18 @@ void randomize( long *seed )
   for ( size_t i = 0; i < 4; i++ ) xseeds[i] = nextxseed( );
 } // randomize
 
+void getrandomstate( unsigned char* state )
+// copy the 32 byte generator state, e.g. for checkpoints
+{
+  memcpy( state, xseeds, sizeof( xseeds ) );
+} // getrandomstate
+
+void setrandomstate( const unsigned char* state )
+// restore a generator state obtained by getrandomstate()
+{
+  memcpy( xseeds, state, sizeof( xseeds ) );
+} // setrandomstate
+
 static inline size_t rotl( const size_t x, int k )
 {
   return ( x << k ) | ( x >> ( 64 - k ) );
@@ -1513,21 +1540,259 @@ void euclidean1( const size_t n, const size_t p, double** z, double** r )
   // }
 } // euclidean1
 
+void sqnorms( const size_t n, const size_t p, double** a, double* r )
+// compute squared euclidean norms r of the rows of a
+{
+  for ( size_t i = 1; i <= n; i++ ) {
+    double sum = 0.0;
+    for ( size_t k = 1; k <= p; k++ ) sum += a[i][k] * a[i][k];
+    r[i] = sum;
+  }
+} // sqnorms
+
+static void normfinish( const size_t p, const double* const z, const double zz, const size_t m, const double* const bt, const size_t ldb, const double* const bb, double* const r )
+// turn cross products -2 z'b in r (0-based) into euclidean distances using |z|^2 + |b|^2 - 2 z'b with squared norms zz and bb;
+// distances that suffer from cancellation are recomputed directly
+{
+  const double REFINE = 0.001;  // relative accuracy of recomputed distances better than DBL_EPSILON / REFINE
+  for ( size_t j = 0; j < m; j++ ) {
+    const double sum = r[j] + zz + bb[j];
+    if ( sum > REFINE * ( zz + bb[j] ) ) r[j] = sqrt( sum );
+    else {
+      double direct = 0.0;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double diff = z[k] - bt[k * ldb + j];
+        direct += diff * diff;
+      }
+      r[j] = sqrt( direct );
+    }
+  }
+} // normfinish
+
+void normdistances( const size_t p, const double* const z, const double zz, const size_t m, const double* const bt, const size_t ldb, const double* const bb, double* const r )
+// compute euclidean distances r (0-based) between z and m points stored dimension major in bt (p by ldb)
+// using |z|^2 + |b|^2 - 2 z'b with squared norms zz and bb; distances that suffer from cancellation are recomputed directly
+{
+  for ( size_t j = 0; j < m; j++ ) r[j] = 0.0;
+  for ( size_t k = 0; k < p; k++ ) {
+    const double zk = -2.0 * z[k];
+    const double* __restrict bk = &bt[k * ldb];
+    double* __restrict rr = &r[0];
+    for ( size_t j = 0; j < m; j++ ) rr[j] += zk * bk[j];
+  }
+  normfinish( p, z, zz, m, bt, ldb, bb, r );
+} // normdistances
+
+static void normdistances4( const size_t p, double** a, const size_t i, const double* const zz, const size_t m, const double* const bt, const size_t ldb, const double* const bb, double** const r, const size_t jr )
+// compute euclidean distances r[i..i+3][jr..jr+m-1] between rows i to i+3 of a and m points stored dimension major in bt (p by ldb)
+// with squared norms zz[0..3] of the rows and bb; the cross products -2 A B' are accumulated in a 4 by 8 register tile
+// over all dimensions, so that each element of bt loaded is used for four rows and each tile is stored once (matrix-matrix product)
+{
+  const size_t NC = 8;
+  const double* const z0 = &a[i][1];
+  const double* const z1 = &a[i + 1][1];
+  const double* const z2 = &a[i + 2][1];
+  const double* const z3 = &a[i + 3][1];
+  double* const r0 = &r[i][jr];
+  double* const r1 = &r[i + 1][jr];
+  double* const r2 = &r[i + 2][jr];
+  double* const r3 = &r[i + 3][jr];
+  size_t j0 = 0;
+  for ( ; j0 + NC <= m; j0 += NC ) {
+    double t0[8] = { 0.0 }, t1[8] = { 0.0 }, t2[8] = { 0.0 }, t3[8] = { 0.0 };
+    for ( size_t k = 0; k < p; k++ ) {
+      const double* __restrict bk = &bt[k * ldb + j0];
+      const double c0 = -2.0 * z0[k];
+      const double c1 = -2.0 * z1[k];
+      const double c2 = -2.0 * z2[k];
+      const double c3 = -2.0 * z3[k];
+      for ( size_t jj = 0; jj < 8; jj++ ) {
+        t0[jj] += c0 * bk[jj];
+        t1[jj] += c1 * bk[jj];
+        t2[jj] += c2 * bk[jj];
+        t3[jj] += c3 * bk[jj];
+      }
+    }
+    for ( size_t jj = 0; jj < 8; jj++ ) {
+      r0[j0 + jj] = t0[jj];
+      r1[j0 + jj] = t1[jj];
+      r2[j0 + jj] = t2[jj];
+      r3[j0 + jj] = t3[jj];
+    }
+  }
+  for ( size_t j = j0; j < m; j++ ) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    for ( size_t k = 0; k < p; k++ ) {
+      const double bkj = bt[k * ldb + j];
+      s0 += z0[k] * bkj;
+      s1 += z1[k] * bkj;
+      s2 += z2[k] * bkj;
+      s3 += z3[k] * bkj;
+    }
+    r0[j] = -2.0 * s0;
+    r1[j] = -2.0 * s1;
+    r2[j] = -2.0 * s2;
+    r3[j] = -2.0 * s3;
+  }
+  normfinish( p, z0, zz[0], m, bt, ldb, bb, r0 );
+  normfinish( p, z1, zz[1], m, bt, ldb, bb, r1 );
+  normfinish( p, z2, zz[2], m, bt, ldb, bb, r2 );
+  normfinish( p, z3, zz[3], m, bt, ldb, bb, r3 );
+} // normdistances4
+
 void euclidean2( const size_t n, const size_t p, double** a, const size_t m, double** b, double** const r )
 // compute euclidean distances r between rows of a and b
+// low dimensionalities use direct differences, higher ones the norm expansion with the cross products a b' as a
+// register blocked matrix-matrix product, four rows of a at a time over column blocks of b
 {
-  for ( size_t j = 1; j <= m; j++ ) {
+  if ( p == 1 ) {
+    for ( size_t i = 1; i <= n; i++ ) {
+      const double ai1 = a[i][1];
+      for ( size_t j = 1; j <= m; j++ ) r[i][j] = fabs( ai1 - b[j][1] );
+    }
+  }
+  else if ( p == 2 ) {
+    for ( size_t i = 1; i <= n; i++ ) {
+      const double ai1 = a[i][1];
+      const double ai2 = a[i][2];
+      for ( size_t j = 1; j <= m; j++ ) {
+        const double d1 = ai1 - b[j][1];
+        const double d2 = ai2 - b[j][2];
+        r[i][j] = sqrt( d1 * d1 + d2 * d2 );
+      }
+    }
+  }
+  else if ( p == 3 ) {
     for ( size_t i = 1; i <= n; i++ ) {
+      const double ai1 = a[i][1];
+      const double ai2 = a[i][2];
+      const double ai3 = a[i][3];
+      for ( size_t j = 1; j <= m; j++ ) {
+        const double d1 = ai1 - b[j][1];
+        const double d2 = ai2 - b[j][2];
+        const double d3 = ai3 - b[j][3];
+        r[i][j] = sqrt( d1 * d1 + d2 * d2 + d3 * d3 );
+      }
+    }
+  }
+  else {
+    const size_t BLOCK = 512;
+    double* bt = ( double* ) calloc( p * m, sizeof( double ) );
+    double* bb = ( double* ) calloc( m, sizeof( double ) );
+    for ( size_t j = 1; j <= m; j++ ) {
       double sum = 0.0;
       for ( size_t k = 1; k <= p; k++ ) {
-        const double diff = a[i][k] - b[j][k];
-        if ( isnotzero( diff ) ) sum += diff * diff;
+        bt[( k - 1 ) * m + j - 1] = b[j][k];
+        sum += b[j][k] * b[j][k];
       }
-      r[i][j] = sqrt( sum );
+      bb[j - 1] = sum;
+    }
+    double* aa = getvector( n, 0.0 );
+    sqnorms( n, p, a, aa );
+    for ( size_t jb = 0; jb < m; jb += BLOCK ) {
+      const size_t mb = min_t( BLOCK, m - jb );
+      size_t i = 1;
+      for ( ; i + 3 <= n; i += 4 ) normdistances4( p, a, i, &aa[i], mb, &bt[jb], m, &bb[jb], r, jb + 1 );
+      for ( ; i <= n; i++ ) normdistances( p, &a[i][1], aa[i], mb, &bt[jb], m, &bb[jb], &r[i][jb + 1] );
     }
+    freevector( aa );
+    free( bt );
+    free( bb );
   }
 } // euclidean2
 
+static double fusedpass( const size_t n, const size_t p, double** a, const size_t m, double** b, double** delta, double** w, const double tiny, double** const d, double** const imb, const bool accumulate )
+// compute euclidean distances d between rows of a and b and the (weighted) ratios imb = w * delta / d for the next B matrix
+// in one pass over column blocks of (groups of four) rows, optionally accumulating the (weighted) residual sum-of-squares; w may be NULL
+{
+  const size_t BLOCK = 512;
+  double* bt = NULL;
+  double* bb = NULL;
+  double* aa = NULL;
+  if ( p > 3 ) {
+    bt = ( double* ) calloc( p * m, sizeof( double ) );
+    bb = ( double* ) calloc( m, sizeof( double ) );
+    for ( size_t j = 1; j <= m; j++ ) {
+      double sum = 0.0;
+      for ( size_t k = 1; k <= p; k++ ) {
+        bt[( k - 1 ) * m + j - 1] = b[j][k];
+        sum += b[j][k] * b[j][k];
+      }
+      bb[j - 1] = sum;
+    }
+    aa = getvector( n, 0.0 );
+    sqnorms( n, p, a, aa );
+  }
+  const size_t NR = ( p > 3 ? 4 : 1 );
+  double fvalue = 0.0;
+  for ( size_t ib = 1; ib <= n; ib += NR ) {
+    const size_t ie = min_t( ib + NR - 1, n );
+    for ( size_t jb = 0; jb < m; jb += BLOCK ) {
+      const size_t je = min_t( jb + BLOCK, m );
+
+      // distances of the block
+      if ( p > 3 ) {
+        if ( ie - ib + 1 == 4 ) normdistances4( p, a, ib, &aa[ib], je - jb, &bt[jb], m, &bb[jb], d, jb + 1 );
+        else for ( size_t i = ib; i <= ie; i++ ) normdistances( p, &a[i][1], aa[i], je - jb, &bt[jb], m, &bb[jb], &d[i][jb + 1] );
+      }
+      else {
+        for ( size_t j = jb + 1; j <= je; j++ ) {
+          double sum = 0.0;
+          for ( size_t k = 1; k <= p; k++ ) {
+            const double diff = a[ib][k] - b[j][k];
+            sum += diff * diff;
+          }
+          d[ib][j] = sqrt( sum );
+        }
+      }
+
+      // residuals and ratios of the block, while d is in cache
+      for ( size_t i = ib; i <= ie; i++ ) {
+        if ( accumulate == false ) {
+          if ( w == NULL ) for ( size_t j = jb + 1; j <= je; j++ ) imb[i][j] = ( d[i][j] < tiny ? 0.0 : delta[i][j] / d[i][j] );
+          else for ( size_t j = jb + 1; j <= je; j++ ) imb[i][j] = ( d[i][j] < tiny ? 0.0 : w[i][j] * delta[i][j] / d[i][j] );
+        }
+        else if ( w == NULL ) {
+          for ( size_t j = jb + 1; j <= je; j++ ) {
+            const double dij = d[i][j];
+            const double work = delta[i][j] - dij;
+            fvalue += work * work;
+            imb[i][j] = ( dij < tiny ? 0.0 : delta[i][j] / dij );
+          }
+        }
+        else {
+          for ( size_t j = jb + 1; j <= je; j++ ) {
+            const double dij = d[i][j];
+            const double work = delta[i][j] - dij;
+            fvalue += w[i][j] * work * work;
+            imb[i][j] = ( dij < tiny ? 0.0 : w[i][j] * delta[i][j] / dij );
+          }
+        }
+      }
+    }
+  }
+  if ( p > 3 ) {
+    free( bt );
+    free( bb );
+    freevector( aa );
+  }
+  return fvalue;
+} // fusedpass
+
+double fusedstress( const size_t n, const size_t p, double** a, const size_t m, double** b, double** delta, double** w, const double tiny, double** const d, double** const imb )
+// compute euclidean distances d between rows of a and b, the (weighted) ratios imb = w * delta / d for the next B matrix,
+// and return the (weighted) residual sum-of-squares, in one pass over column blocks of each row; w may be NULL
+{
+  return fusedpass( n, p, a, m, b, delta, w, tiny, d, imb, true );
+} // fusedstress
+
+void fusedratios( const size_t n, const size_t p, double** a, const size_t m, double** b, double** delta, double** w, const double tiny, double** const d, double** const imb )
+// compute euclidean distances d between rows of a and b and the (weighted) ratios imb = w * delta / d for the next B matrix,
+// without evaluating the residuals; w may be NULL
+{
+  fusedpass( n, p, a, m, b, delta, w, tiny, d, imb, false );
+} // fusedratios
+
 void squaredeuclidean1( const size_t n, const size_t p, double** a, double** r )
 // compute euclidean distances r between rows of a and b
 {
@@ -3383,6 +3648,176 @@ int solve( const size_t n, double** a, double* b )
   return retval;
 } // solve
 
+int choldcmp( const size_t n, double** a )
+// Cholesky factorization a = ll' of the symmetric n by n matrix a in place, nonzero if a is not positive definite
+{
+  return chdcmp( &a[1][1], n );
+} // choldcmp
+
+int cholsolve( const size_t n, double** l, double* b )
+// solve ll' x = b for the factor l of choldcmp(), with the solution returned in b
+{
+  return chsolve( &l[1][1], &b[1], n );
+} // cholsolve
+
+size_t sglasso( const size_t h, const size_t p, double** a, double** c, const double lambda1, const double lambda2, const size_t MAXITER, const double TOL, double** b )
+// minimize 0.5 tr( b'ab ) - tr( b'c ) + lambda1 sum |b_ik| + lambda2 sum ||b_i|| over the h by p matrix b
+// by block coordinate descent over the rows of b, starting from b, for symmetric a with positive diagonal
+// each row update is exact: soft-thresholding by lambda1 followed by group shrinkage by lambda2
+// rows that are zero are skipped in the products, and the number of sweeps is returned
+{
+  bool* nz = getbvector( h, false );
+  double* z = getvector( p, 0.0 );
+  for ( size_t i = 1; i <= h; i++ ) for ( size_t k = 1; k <= p; k++ ) if ( b[i][k] != 0.0 ) nz[i] = true;
+  size_t iter = 0;
+  for ( iter = 1; iter <= MAXITER; iter++ ) {
+    double bmax = 0.0;
+    double dmax = 0.0;
+    for ( size_t i = 1; i <= h; i++ ) {
+      if ( a[i][i] <= 0.0 ) continue;
+
+      // partial residual of row i
+      for ( size_t k = 1; k <= p; k++ ) z[k] = c[i][k];
+      for ( size_t j = 1; j <= h; j++ ) {
+        if ( j == i || nz[j] == false ) continue;
+        const double aij = a[i][j];
+        for ( size_t k = 1; k <= p; k++ ) z[k] -= aij * b[j][k];
+      }
+
+      // soft-thresholding and group shrinkage
+      double ssq = 0.0;
+      for ( size_t k = 1; k <= p; k++ ) {
+        const double work = fabs( z[k] ) - lambda1;
+        z[k] = ( work > 0.0 ? copysign( work, z[k] ) : 0.0 );
+        ssq += z[k] * z[k];
+      }
+      const double nrm = sqrt( ssq );
+      const double shrink = ( nrm > lambda2 ? ( 1.0 - lambda2 / nrm ) / a[i][i] : 0.0 );
+      nz[i] = shrink > 0.0;
+      for ( size_t k = 1; k <= p; k++ ) {
+        const double work = shrink * z[k];
+        const double dif = fabs( work - b[i][k] );
+        if ( dif > dmax ) dmax = dif;
+        if ( fabs( work ) > bmax ) bmax = fabs( work );
+        b[i][k] = work;
+      }
+    }
+    if ( dmax <= TOL * fmax( 1.0, bmax ) ) break;
+  }
+  freebvector( nz );
+  freevector( z );
+  return( iter > MAXITER ? MAXITER : iter );
+} // sglasso
+
+void cscmm( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const size_t p, double** b, double** x )
+// x = q b for the n by h matrix q in compressed sparse column format (0-based colptr and rows)
+{
+  for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) x[i][k] = 0.0;
+  for ( size_t j = 1; j <= h; j++ ) {
+    for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) {
+      const double work = vals[l];
+      double* xi = &x[rows[l] + 1][0];
+      for ( size_t k = 1; k <= p; k++ ) xi[k] += work * b[j][k];
+    }
+  }
+} // cscmm
+
+void csctmm( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const size_t p, double** x, double** c )
+// c = q'x for the n by h matrix q in compressed sparse column format (0-based colptr and rows)
+{
+  for ( size_t j = 1; j <= h; j++ ) {
+    for ( size_t k = 1; k <= p; k++ ) c[j][k] = 0.0;
+    for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) {
+      const double work = vals[l];
+      const double* xi = &x[rows[l] + 1][0];
+      for ( size_t k = 1; k <= p; k++ ) c[j][k] += work * xi[k];
+    }
+  }
+} // csctmm
+
+size_t csccg( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const double alpha, const size_t p, double** c, double** b, const size_t MAXITER, const double TOL )
+// solve alpha q'q b = c for the h by p matrix b by Jacobi preconditioned conjugate gradients, starting from b,
+// for the n by h matrix q in compressed sparse column format (0-based colptr and rows)
+// q'q is never formed, each iteration costs two passes over the nonzeros of q
+// empty columns of q receive zero coefficients, and the largest number of iterations over the columns of b is returned
+{
+  double* dinv = getvector( h, 0.0 );
+  double* r = getvector( h, 0.0 );
+  double* z = getvector( h, 0.0 );
+  double* s = getvector( h, 0.0 );
+  double* as = getvector( h, 0.0 );
+  double* t = getvector( n, 0.0 );
+  for ( size_t j = 1; j <= h; j++ ) {
+    double work = 0.0;
+    for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) work += vals[l] * vals[l];
+    dinv[j] = ( work > 0.0 ? 1.0 / ( alpha * work ) : 0.0 );
+  }
+  size_t maxiter = 0;
+  for ( size_t k = 1; k <= p; k++ ) {
+
+    // residual r = c - alpha q'q b
+    for ( size_t i = 1; i <= n; i++ ) t[i] = 0.0;
+    for ( size_t j = 1; j <= h; j++ ) {
+      if ( dinv[j] == 0.0 ) b[j][k] = 0.0;
+      const double bj = b[j][k];
+      for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) t[rows[l] + 1] += vals[l] * bj;
+    }
+    double cnrm = 0.0;
+    double rz = 0.0;
+    for ( size_t j = 1; j <= h; j++ ) {
+      double work = 0.0;
+      for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) work += vals[l] * t[rows[l] + 1];
+      r[j] = ( dinv[j] == 0.0 ? 0.0 : c[j][k] - alpha * work );
+      z[j] = dinv[j] * r[j];
+      s[j] = z[j];
+      rz += r[j] * z[j];
+      cnrm += c[j][k] * c[j][k];
+    }
+    const double crit = TOL * TOL * cnrm;
+
+    // conjugate gradient iterations
+    size_t iter = 0;
+    for ( iter = 1; iter <= MAXITER; iter++ ) {
+      double rr = 0.0;
+      for ( size_t j = 1; j <= h; j++ ) rr += r[j] * r[j];
+      if ( rr <= crit || rz <= 0.0 ) break;
+      for ( size_t i = 1; i <= n; i++ ) t[i] = 0.0;
+      for ( size_t j = 1; j <= h; j++ ) {
+        const double sj = s[j];
+        if ( sj == 0.0 ) continue;
+        for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) t[rows[l] + 1] += vals[l] * sj;
+      }
+      double sas = 0.0;
+      for ( size_t j = 1; j <= h; j++ ) {
+        double work = 0.0;
+        for ( int l = colptr[j - 1]; l < colptr[j]; l++ ) work += vals[l] * t[rows[l] + 1];
+        as[j] = alpha * work;
+        sas += s[j] * as[j];
+      }
+      if ( sas <= 0.0 ) break;
+      const double step = rz / sas;
+      double rznew = 0.0;
+      for ( size_t j = 1; j <= h; j++ ) {
+        b[j][k] += step * s[j];
+        r[j] -= step * as[j];
+        z[j] = dinv[j] * r[j];
+        rznew += r[j] * z[j];
+      }
+      const double beta = rznew / rz;
+      for ( size_t j = 1; j <= h; j++ ) s[j] = z[j] + beta * s[j];
+      rz = rznew;
+    }
+    if ( iter > maxiter ) maxiter = iter;
+  }
+  freevector( dinv );
+  freevector( r );
+  freevector( z );
+  freevector( s );
+  freevector( as );
+  freevector( t );
+  return( maxiter > MAXITER ? MAXITER : maxiter );
+} // csccg
+
 static void lstsq( const size_t m, double** xtx, double* xty, bool* p, double* b )
 // solve y = Xb for b and return b
 {
@@ -5675,30 +6110,28 @@ char* getdatetime( void )
 
 
 
-size_t setstarttime( void )
-// return current time in time_t format
+uint64_t setstarttime( void )
+// return current time of a monotonic clock in nanoseconds, unaffected by changes of the system time
+// windows has no clock_gettime() without the pthreads library and uses the performance counter instead
 {
-  #ifdef R
-    return( 0 );
-  #else
-    struct timespec current_time;
-    if ( clock_gettime( CLOCK_REALTIME, &current_time ) != 0 ) return 0;
-    return current_time.tv_sec * CLOCKS_PER_SEC + current_time.tv_nsec / ( 1000000000 / CLOCKS_PER_SEC ); 
-  #endif
+#ifdef _WIN32
+  LARGE_INTEGER counter;
+  LARGE_INTEGER frequency;
+  if ( QueryPerformanceCounter( &counter ) == 0 || QueryPerformanceFrequency( &frequency ) == 0 ) return 0;
+  const uint64_t ticks = ( uint64_t )( counter.QuadPart );
+  const uint64_t hz = ( uint64_t )( frequency.QuadPart );
+  return ( ticks / hz ) * 1000000000u + ( ( ticks % hz ) * 1000000000u ) / hz;
+#else
+  struct timespec current_time;
+  if ( clock_gettime( CLOCK_MONOTONIC, &current_time ) != 0 ) return 0;
+  return ( uint64_t )( current_time.tv_sec ) * 1000000000u + ( uint64_t )( current_time.tv_nsec );
+#endif
 } // setstarttime
 
-double getelapsedtime( const size_t starttime )
-// get current time in time_t format
-// return time difference in seconds in double format
+double getelapsedtime( const uint64_t starttime )
+// return time elapsed since starttime, obtained by setstarttime(), in seconds
 {
-  #ifdef R
-    return( 0.0 );
-  #else
-    struct timespec current_time;
-    if ( clock_gettime( CLOCK_REALTIME, &current_time ) != 0 ) return 0.0;
-    size_t endtime = ( size_t )( current_time.tv_sec * CLOCKS_PER_SEC + current_time.tv_nsec / ( 1000000000 / CLOCKS_PER_SEC ) ); 
-    return( ( double )( endtime - starttime ) / 1000.0 );
-  #endif
+  return ( double )( setstarttime( ) - starttime ) * 1.0e-9;
 } // getelapsedtime
 
 void lowercase( char* str )
@@ -7,7 +7,9 @@
 #ifndef FLIB_H
 #define FLIB_H
 
-#define R
+#ifndef FMDU_STANDALONE
+  #define R
+#endif
 
 #include <stdbool.h>
 #include <assert.h>
@@ -17,6 +19,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
 #include <limits.h>
 #include <ctype.h>
 
@@ -46,6 +49,8 @@ extern bool isnotsysmis( const double a );
 extern double plogis( const double x );
 
 extern void randomize( long *seed );
+extern void getrandomstate( unsigned char* state );
+extern void setrandomstate( const unsigned char* state );
 extern size_t nextsize_t( void );
 extern double nextdouble( void );
 extern size_t duniform( const size_t n1, const size_t n2 );
@@ -80,7 +85,11 @@ extern double stddev( const size_t n, const double* const a, const size_t inca )
 extern double fdist1( const size_t p, double* x, double* y );
 extern double fdist( size_t n, double* x, double* y, const size_t inc );
 extern void euclidean1( const size_t n, const size_t p, double** a, double** const r );
+extern void sqnorms( const size_t n, const size_t p, double** a, double* r );
+extern void normdistances( const size_t p, const double* const z, const double zz, const size_t m, const double* const bt, const size_t ldb, const double* const bb, double* const r );
 extern void euclidean2( const size_t n, const size_t p, double** a, const size_t m, double** b, double** const r );
+extern double fusedstress( const size_t n, const size_t p, double** a, const size_t m, double** b, double** delta, double** w, const double tiny, double** const d, double** const imb );
+extern void fusedratios( const size_t n, const size_t p, double** a, const size_t m, double** b, double** delta, double** w, const double tiny, double** const d, double** const imb );
 extern void squaredeuclidean1( const size_t n, const size_t p, double** a, double** const r );
 extern void squaredeuclidean2( const size_t n, const size_t p, double** a, const size_t m, double** b, double** const r );
 extern void dsort( const size_t n, double* const a, size_t* const r );
@@ -124,6 +133,12 @@ extern int mpinverse( const size_t n, const size_t m, double **a, double **inva
 extern int evdcmp( const size_t n, double** vecs, double* vals );
 extern int svdcmp( const size_t n, const size_t m, double** const a, double** const u, double* w, double** const v );
 extern int solve( const size_t n, double** a, double* b );
+extern int choldcmp( const size_t n, double** a );
+extern int cholsolve( const size_t n, double** l, double* b );
+extern size_t sglasso( const size_t h, const size_t p, double** a, double** c, const double lambda1, const double lambda2, const size_t MAXITER, const double TOL, double** b );
+extern void cscmm( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const size_t p, double** b, double** x );
+extern void csctmm( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const size_t p, double** x, double** c );
+extern size_t csccg( const size_t n, const size_t h, const int* colptr, const int* rows, const double* vals, const double alpha, const size_t p, double** c, double** b, const size_t MAXITER, const double TOL );
 
 extern void nnintercept( const bool symmetric, const size_t n, double** x, double** y, const double mconst, double** w, double** r );
 extern void nnslope( const bool symmetric, const size_t n, double** x, double** y, const double mconst, double** w, double** r );
@@ -177,8 +192,8 @@ extern void writematrix( char* name, const size_t n, const size_t m, double** a
 
 extern double** readmatrix( char* infilename, size_t *n, size_t *m );
 extern char* getdatetime(void);
-extern size_t setstarttime( void );
-extern double getelapsedtime( const size_t starttime );
+extern uint64_t setstarttime( void );
+extern double getelapsedtime( const uint64_t starttime );
 
 typedef char char32[32];
 typedef char char1024[1024];
@@ -4,8 +4,47 @@
 // This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
 //
 
-#define R
+#ifndef FMDU_STANDALONE
+  #define R
+#endif
 
 #include "fmdu.h"
 
 // main for fmdu library
+
+void Crandomproblem( int* rn, int* rm, int* rp, int* rseed, double* rerror, double* rdelta, double* rx, double* ry )
+// Function Crandomproblem() draws a reproducible unfolding problem: the n by m block of randomDelta() dissimilarities
+// among n + m objects in p dimensions with error proportion error, and randomZ() starting configurations x and y.
+// Normal error can push small dissimilarities below zero, these are clamped at zero so that the problem is routed
+// to the nonnegative engines.
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t p = *rp;
+  const long seed = ( long )( *rseed );
+  const double error = *rerror;
+
+  // run function
+  int* vdist = getivector( p, 1 );
+  double* vssq = getvector( p, 1.0 );
+  double** full = getmatrix( n + m, n + m, 0.0 );
+  randomDelta( n + m, p, vdist, vssq, 2, error, seed, full );
+  double** x = getmatrix( n, p, 0.0 );
+  randomZ( n, p, x, seed + 1 );
+  double** y = getmatrix( m, p, 0.0 );
+  randomZ( m, p, y, seed + 2 );
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rdelta[k] = fmax( 0.0, full[i][n + j] );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) ry[k] = y[i][j];
+
+  // de-allocate memory
+  freeivector( vdist );
+  freevector( vssq );
+  freematrix( full );
+  freematrix( x );
+  freematrix( y );
+
+} // Crandomproblem
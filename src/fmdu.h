@@ -7,44 +7,78 @@
 #ifndef FMDU_H
 #define FMDU_H
 
-#define R
+#ifndef FMDU_STANDALONE
+  #define R
+#endif
 
 #include "flib.h"
-
-
-extern double mdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double wgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double mduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double wgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double penrowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double rowreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double rowresmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double rowreswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double colresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double pencolresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double colresmduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double colreswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double resmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double reswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double resmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-extern double reswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern double external( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** const fixed, double** const z, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo );
-
-extern void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed );
-
-extern void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
+#include "scorer.h"
+#include "design.h"
+#include "control.h"
+#include "registry.h"
+
+
+extern double mdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool lagged, fitcontrol* control, const bool echo );
+extern double wgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double mduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double wgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const design* dq, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double sprowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, const int* qp, const int* qi, const double* qx, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double penrowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** qtq, double** b, double** y, int** fy, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double rowreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double rowresmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double rowreswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double colresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const design* dq, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double spcolresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, const int* qp, const int* qi, const double* qx, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double pencolresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** qtq, double** b, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double colreswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double colresmduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double colreswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double resmdu( const size_t n, const size_t m, double** delta, const size_t p, const design* dx, double** bx, const design* dy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double spresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, const int* qxp, const int* qxi, const double* qxx, double** bx, const size_t hy, const int* qyp, const int* qyi, const double* qyx, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double reswgtmdu( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double resmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+extern double reswgtmduneg( const size_t n, const size_t m, double** delta, double** w, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo );
+
+extern double external( const size_t n, const size_t m, double** delta, double** w, const size_t p, double** const fixed, double** const z, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const fitcontrol* control, int* status, const bool echo, const size_t nthreads );
+extern double spexternal( const size_t n, const size_t m, const size_t* rowptr, const size_t* cols, const double* delta, const double* w, const size_t p, double** fixed, double** z, double* d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const fitcontrol* control, int* status, const size_t nthreads );
+
+extern void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rstate, unsigned char* rrng, double* rbudget, int* rstatus );
+extern void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastblkmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastblkmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastbatmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rbatchsize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastmduneg( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastmdunegfxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmduneg( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdunegfxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+
+extern void CRnewonline( int* rn, int* rm, double* rdata, int* rw, int* rhandle );
+extern void CRonlineaddrows( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus );
+extern void CRonlineaddcols( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus );
+extern void CRonlinesetcells( int* rhandle, int* rn, int* rm, int* rk, int* ri, int* rj, double* rvalue, int* rw, int* rstatus );
+extern void CRonlinerefresh( int* rhandle, int* rn, int* rm, int* rp, double* rx, int* rfr, double* ry, int* rfc, int* rfreeze, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRfreeonline( int* rhandle );
+extern void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+
+extern void nearest( const size_t n, const size_t p, const double* x, const size_t m, const double* y, const size_t k, size_t* index, double* dist, const size_t nthreads );
+extern void CRnearest( int* rn, int* rp, double* rx, int* rm, double* ry, int* rk, int* rindex, double* rdist, int* rnthreads );
+
+extern void CRnewscorer( int* rm, int* rp, double* rfixed, int* rmaxiter, double* rfcrit, int* rhandle );
+extern void CRscore( int* rhandle, int* rn, double* rdelta, double* rw, int* rhasw, double* rz, double* rfvalues, int* riters, int* rstatus );
+extern void CRfreescorer( int* rhandle );
+extern void CRnewdesign( int* rn, int* rh, double* rq, int* rhandle );
+extern void CRfreedesign( int* rhandle );
+
+extern void Crandomproblem( int* rn, int* rm, int* rp, int* rseed, double* rerror, double* rdelta, double* rx, double* ry );
 
 #endif
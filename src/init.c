@@ -4,62 +4,116 @@
 #include <R_ext/Rdynload.h>
 #define R
 
-extern void Ccolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Ccolreswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Creswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Creswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Crowresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Crowreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Crowreswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cwgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cwgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed );
-extern void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed );
+extern void Ccolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, int* rdesign, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Ccolresmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Ccolreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Ccolreswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* rlagged, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, int* rdesignx, double* rbx, int* rhy, double* rqy, int* rdesigny, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Creswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Creswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, int* rdesign, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Crowresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Crowreswgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Crowreswgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cwgtmdu( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cwgtmduneg( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cbatchmdu( int* rnproblems, int* rn, int* rm, double* rdelta, double* rw, int* rhasw, int* rp, double* rx, double* ry, double* rd, int* rmaxiter, double* rfdif, double* rfvalues, int* riters, double* rbudget, int* rstatus, int* rnthreads );
+extern void Cexternal( int* rn, int* rm, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* riters, double* rbudget, int* rstatus, int* rnthreads, int* recho );
+extern void Cspexternal( int* rn, int* rm, int* rrowptr, int* rcols, double* rdelta, double* rw, int* rp, double* rfixed, double* rz, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* riters, double* rbudget, int* rstatus, int* rnthreads );
+extern void CRultrafastmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rstate, unsigned char* rrng, double* rbudget, int* rstatus );
+extern void CRultrafastmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdu( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdufxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastblkmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastblkmdufxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rblocksize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastbatmdu( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rbatchsize, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastmduneg( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastmdunegfxd( int* rn, int* rm, double* rdata, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmduneg( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRultrafastwgtmdunegfxd( int* rn, int* rm, double* rdata, int* rw, int* rp, double* rx, int* rfx, double* ry, int* rfy, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRnewonline( int* rn, int* rm, double* rdata, int* rw, int* rhandle );
+extern void CRonlineaddrows( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus );
+extern void CRonlineaddcols( int* rhandle, int* rn, int* rm, int* rk, double* rdata, int* rw, int* rstatus );
+extern void CRonlinesetcells( int* rhandle, int* rn, int* rm, int* rk, int* ri, int* rj, double* rvalue, int* rw, int* rstatus );
+extern void CRonlinerefresh( int* rhandle, int* rn, int* rm, int* rp, double* rx, int* rfr, double* ry, int* rfc, int* rfreeze, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
+extern void CRfreeonline( int* rhandle );
+extern void CRultrafastmdu2( int* rn, int* rm, double* rdata, int* rp, double* rx, double* ry, int* rnsteps, double* rminrate, int* rseed, int* rschedule, double* rbudget, int* rstatus );
 extern void CRultrafastrowresmdu( int* rn, int* rm, double* rdata, int* rp, int* rh, double* rq, double* rb, double* ry, int* rnsteps, double* rminrate, int* rseed );
+extern void CRnearest( int* rn, int* rp, double* rx, int* rm, double* ry, int* rk, int* rindex, double* rdist, int* rnthreads );
+extern void CRnewscorer( int* rm, int* rp, double* rfixed, int* rmaxiter, double* rfcrit, int* rhandle );
+extern void CRscore( int* rhandle, int* rn, double* rdelta, double* rw, int* rhasw, double* rz, double* rfvalues, int* riters, int* rstatus );
+extern void CRfreescorer( int* rhandle );
+extern void CRnewdesign( int* rn, int* rh, double* rq, int* rhandle );
+extern void CRfreedesign( int* rhandle );
+extern void Crandomproblem( int* rn, int* rm, int* rp, int* rseed, double* rerror, double* rdelta, double* rx, double* ry );
 
 
-extern void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
-extern void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, int* recho );
+extern void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, int* rdesign, double* rb, double* ry, int* rfy, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, int* rdesign, double* rb, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cpenrowresmdupath( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rnlambda, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rpathb, double* rpathy, double* rfvalues, double* rnstress, int* rzeros, int* riters, int* rstatus, int* recho );
+extern void Cpencolresmdupath( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rnlambda, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rpathb, double* rpathx, double* rfvalues, double* rnstress, int* rzeros, int* riters, int* rstatus, int* recho );
+extern void Csprowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, int* rqp, int* rqi, double* rqx, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cspcolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, int* rqp, int* rqi, double* rqx, double* rb, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
+extern void Cspresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, int* rqxp, int* rqxi, double* rqxx, double* rbx, int* rhy, int* rqyp, int* rqyi, double* rqyx, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho );
 
 
 
 static const R_CMethodDef CEntries[] = {
-  {"Ccolresmdu",      ( DL_FUNC ) &Ccolresmdu,         14},
-  {"Ccolresmduneg",      ( DL_FUNC ) &Ccolresmduneg,         14},
-  {"Ccolreswgtmdu",      ( DL_FUNC ) &Ccolreswgtmdu,         15},
-  {"Ccolreswgtmduneg",      ( DL_FUNC ) &Ccolreswgtmduneg,         15},
-  {"Cmdu",      ( DL_FUNC ) &Cmdu,         13},
-  {"Cmduneg",      ( DL_FUNC ) &Cmduneg,         13},
-  {"Cresmdu",      ( DL_FUNC ) &Cresmdu,         15},
-  {"Cresmduneg",      ( DL_FUNC ) &Cresmduneg,         15},
-  {"Creswgtmdu",      ( DL_FUNC ) &Creswgtmdu,         16},
-  {"Creswgtmduneg",      ( DL_FUNC ) &Creswgtmduneg,         16},
-  {"Crowresmdu",      ( DL_FUNC ) &Crowresmdu,         14},
-  {"Crowresmduneg",      ( DL_FUNC ) &Crowresmduneg,         14},
-  {"Crowreswgtmdu",      ( DL_FUNC ) &Crowreswgtmdu,         15},
-  {"Crowreswgtmduneg",      ( DL_FUNC ) &Crowreswgtmduneg,         15},
-  {"Cwgtmdu",      ( DL_FUNC ) &Cwgtmdu,         14},
-  {"Cwgtmduneg",      ( DL_FUNC ) &Cwgtmduneg,         14},
-  {"Cexternal",      ( DL_FUNC ) &Cexternal,         12},
-  {"CRultrafastmdu",      ( DL_FUNC ) &CRultrafastmdu,         9},
-  {"CRultrafastmdufxd",      ( DL_FUNC ) &CRultrafastmdufxd,         11},
-  {"CRultrafastwgtmdu",      ( DL_FUNC ) &CRultrafastwgtmdu,         10},
-  {"CRultrafastwgtmdufxd",      ( DL_FUNC ) &CRultrafastwgtmdufxd,         12},
-  {"CRultrafastmdu2",      ( DL_FUNC ) &CRultrafastmdu2,         9},
+  {"Ccolresmdu",      ( DL_FUNC ) &Ccolresmdu,         23},
+  {"Ccolresmduneg",      ( DL_FUNC ) &Ccolresmduneg,         22},
+  {"Ccolreswgtmdu",      ( DL_FUNC ) &Ccolreswgtmdu,         23},
+  {"Ccolreswgtmduneg",      ( DL_FUNC ) &Ccolreswgtmduneg,         23},
+  {"Cmdu",      ( DL_FUNC ) &Cmdu,         22},
+  {"Cmduneg",      ( DL_FUNC ) &Cmduneg,         21},
+  {"Cresmdu",      ( DL_FUNC ) &Cresmdu,         25},
+  {"Cresmduneg",      ( DL_FUNC ) &Cresmduneg,         23},
+  {"Creswgtmdu",      ( DL_FUNC ) &Creswgtmdu,         24},
+  {"Creswgtmduneg",      ( DL_FUNC ) &Creswgtmduneg,         24},
+  {"Crowresmdu",      ( DL_FUNC ) &Crowresmdu,         23},
+  {"Crowresmduneg",      ( DL_FUNC ) &Crowresmduneg,         22},
+  {"Crowreswgtmdu",      ( DL_FUNC ) &Crowreswgtmdu,         23},
+  {"Crowreswgtmduneg",      ( DL_FUNC ) &Crowreswgtmduneg,         23},
+  {"Cwgtmdu",      ( DL_FUNC ) &Cwgtmdu,         22},
+  {"Cwgtmduneg",      ( DL_FUNC ) &Cwgtmduneg,         22},
+  {"Cbatchmdu",      ( DL_FUNC ) &Cbatchmdu,         17},
+  {"Cexternal",      ( DL_FUNC ) &Cexternal,         16},
+  {"Cspexternal",      ( DL_FUNC ) &Cspexternal,         17},
+  {"CRultrafastmdu",      ( DL_FUNC ) &CRultrafastmdu,         17},
+  {"CRultrafastmdufxd",      ( DL_FUNC ) &CRultrafastmdufxd,         14},
+  {"CRultrafastwgtmdu",      ( DL_FUNC ) &CRultrafastwgtmdu,         13},
+  {"CRultrafastwgtmdufxd",      ( DL_FUNC ) &CRultrafastwgtmdufxd,         15},
+  {"CRultrafastblkmdu",      ( DL_FUNC ) &CRultrafastblkmdu,         13},
+  {"CRultrafastblkmdufxd",      ( DL_FUNC ) &CRultrafastblkmdufxd,         15},
+  {"CRultrafastbatmdu",      ( DL_FUNC ) &CRultrafastbatmdu,         13},
+  {"CRultrafastmduneg",      ( DL_FUNC ) &CRultrafastmduneg,         12},
+  {"CRultrafastmdunegfxd",      ( DL_FUNC ) &CRultrafastmdunegfxd,         14},
+  {"CRultrafastwgtmduneg",      ( DL_FUNC ) &CRultrafastwgtmduneg,         13},
+  {"CRultrafastwgtmdunegfxd",      ( DL_FUNC ) &CRultrafastwgtmdunegfxd,         15},
+  {"CRnewonline",      ( DL_FUNC ) &CRnewonline,         5},
+  {"CRonlineaddrows",      ( DL_FUNC ) &CRonlineaddrows,         7},
+  {"CRonlineaddcols",      ( DL_FUNC ) &CRonlineaddcols,         7},
+  {"CRonlinesetcells",      ( DL_FUNC ) &CRonlinesetcells,         9},
+  {"CRonlinerefresh",      ( DL_FUNC ) &CRonlinerefresh,         15},
+  {"CRfreeonline",      ( DL_FUNC ) &CRfreeonline,         1},
+  {"CRultrafastmdu2",      ( DL_FUNC ) &CRultrafastmdu2,        12},
   {"CRultrafastrowresmdu",      ( DL_FUNC ) &CRultrafastrowresmdu,         11},
-  {"Cpenrowresmdu",      ( DL_FUNC ) &Cpenrowresmdu,         17},
-  {"Cpencolresmdu",      ( DL_FUNC ) &Cpencolresmdu,         17},
+  {"CRnearest",      ( DL_FUNC ) &CRnearest,         9},
+  {"CRnewscorer",      ( DL_FUNC ) &CRnewscorer,         6},
+  {"CRscore",      ( DL_FUNC ) &CRscore,         9},
+  {"CRfreescorer",      ( DL_FUNC ) &CRfreescorer,         1},
+  {"CRnewdesign",      ( DL_FUNC ) &CRnewdesign,         4},
+  {"CRfreedesign",      ( DL_FUNC ) &CRfreedesign,         1},
+  {"Crandomproblem",      ( DL_FUNC ) &Crandomproblem,         8},
+  {"Cpenrowresmdu",      ( DL_FUNC ) &Cpenrowresmdu,         26},
+  {"Cpencolresmdu",      ( DL_FUNC ) &Cpencolresmdu,         26},
+  {"Cpenrowresmdupath",      ( DL_FUNC ) &Cpenrowresmdupath,         24},
+  {"Cpencolresmdupath",      ( DL_FUNC ) &Cpencolresmdupath,         24},
+  {"Csprowresmdu",      ( DL_FUNC ) &Csprowresmdu,         24},
+  {"Cspcolresmdu",      ( DL_FUNC ) &Cspcolresmdu,         24},
+  {"Cspresmdu",      ( DL_FUNC ) &Cspresmdu,         27},
   {NULL, NULL, 0}
 };
 
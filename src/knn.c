@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include "fmdu.h"
+
+// k-d tree over the rows of an m by p configuration (row major) for top-k nearest neighbor queries
+// nodes split at the median of the dimension with the largest spread, leaves hold at most LEAFSIZE points,
+// points are copied in tree order such that leaves are contiguous in memory
+
+static const size_t LEAFSIZE = 16;
+static const size_t MAXKDDIM = 8;  // above this dimensionality, pruning fails and queries scan all points
+
+typedef struct kdnode_struct {
+  size_t lo;      // first point (tree order)
+  size_t hi;      // one past last point
+  size_t dim;     // split dimension
+  double split;   // split value
+  size_t left;    // child nodes, 0 for a leaf
+  size_t right;
+} kdnode;
+
+typedef struct kdtree_struct {
+  size_t m;
+  size_t p;
+  size_t nnodes;
+  kdnode* nodes;
+  size_t* perm;   // tree order to original index
+  double* pts;    // points in tree order, m by p
+} kdtree;
+
+static void kdselect( const size_t p, const double* y, size_t* perm, size_t lo, size_t hi, const size_t mid, const size_t dim )
+// partially order perm[lo..hi) such that perm[mid] has the median coordinate dim (quickselect)
+{
+  while ( hi - lo > 1 ) {
+    const double pivot = y[perm[lo + ( hi - lo ) / 2] * p + dim];
+    size_t i = lo;
+    size_t j = hi - 1;
+    while ( i <= j ) {
+      while ( y[perm[i] * p + dim] < pivot ) i++;
+      while ( y[perm[j] * p + dim] > pivot ) j--;
+      if ( i <= j ) {
+        const size_t t = perm[i];
+        perm[i] = perm[j];
+        perm[j] = t;
+        i++;
+        if ( j == 0 ) break;
+        j--;
+      }
+    }
+    if ( mid <= j ) hi = j + 1;
+    else if ( mid >= i ) lo = i;
+    else return;
+  }
+} // kdselect
+
+static size_t kdbuild( kdtree* t, const double* y, const size_t lo, const size_t hi )
+// build the subtree for points perm[lo..hi) and return its node number
+{
+  const size_t node = t->nnodes++;
+  kdnode* nd = &t->nodes[node];
+  nd->lo = lo;
+  nd->hi = hi;
+  nd->left = nd->right = 0;
+  if ( hi - lo <= LEAFSIZE ) return node;
+
+  // split dimension: largest spread
+  const size_t p = t->p;
+  size_t dim = 0;
+  double spread = -1.0;
+  for ( size_t k = 0; k < p; k++ ) {
+    double mn = DBL_MAX;
+    double mx = -DBL_MAX;
+    for ( size_t i = lo; i < hi; i++ ) {
+      const double v = y[t->perm[i] * p + k];
+      if ( v < mn ) mn = v;
+      if ( v > mx ) mx = v;
+    }
+    if ( mx - mn > spread ) {
+      spread = mx - mn;
+      dim = k;
+    }
+  }
+  const size_t mid = lo + ( hi - lo ) / 2;
+  kdselect( p, y, t->perm, lo, hi, mid, dim );
+  const double split = y[t->perm[mid] * p + dim];
+  const size_t left = kdbuild( t, y, lo, mid );
+  const size_t right = kdbuild( t, y, mid, hi );
+  nd = &t->nodes[node];
+  nd->dim = dim;
+  nd->split = split;
+  nd->left = left;
+  nd->right = right;
+  return node;
+} // kdbuild
+
+static kdtree* newkdtree( const size_t m, const size_t p, const double* y )
+// build a k-d tree for the m by p configuration y (row major)
+{
+  kdtree* t = ( kdtree* ) calloc( 1, sizeof( kdtree ) );
+  t->m = m;
+  t->p = p;
+  t->nodes = ( kdnode* ) calloc( 2 * ( m / ( LEAFSIZE / 2 ) + 1 ), sizeof( kdnode ) );  // leaves hold more than LEAFSIZE / 2 points
+  t->perm = ( size_t* ) calloc( m, sizeof( size_t ) );
+  t->pts = ( double* ) calloc( m * p, sizeof( double ) );
+  for ( size_t j = 0; j < m; j++ ) t->perm[j] = j;
+  if ( p <= MAXKDDIM ) kdbuild( t, y, 0, m );
+  else {
+    t->nodes[0].lo = 0;
+    t->nodes[0].hi = m;
+    t->nnodes = 1;
+  }
+  for ( size_t j = 0; j < m; j++ ) for ( size_t k = 0; k < p; k++ ) t->pts[j * p + k] = y[t->perm[j] * p + k];
+  return t;
+} // newkdtree
+
+static void freekdtree( kdtree* t )
+{
+  free( t->nodes );
+  free( t->perm );
+  free( t->pts );
+  free( t );
+} // freekdtree
+
+static void heapinsert( const size_t k, size_t* count, double* hd, size_t* hi, const double d, const size_t idx )
+// insert (d,idx) in the max-heap of the k best candidates
+{
+  size_t c;
+  if ( *count < k ) c = ( *count )++;
+  else if ( d < hd[0] ) {
+    // replace root and sift down
+    size_t r = 0;
+    for ( ;; ) {
+      const size_t l = 2 * r + 1;
+      if ( l >= k ) break;
+      const size_t g = ( l + 1 < k && hd[l + 1] > hd[l] ? l + 1 : l );
+      if ( hd[g] <= d ) break;
+      hd[r] = hd[g];
+      hi[r] = hi[g];
+      r = g;
+    }
+    hd[r] = d;
+    hi[r] = idx;
+    return;
+  }
+  else return;
+
+  // sift up
+  while ( c > 0 ) {
+    const size_t par = ( c - 1 ) / 2;
+    if ( hd[par] >= d ) break;
+    hd[c] = hd[par];
+    hi[c] = hi[par];
+    c = par;
+  }
+  hd[c] = d;
+  hi[c] = idx;
+} // heapinsert
+
+static void kdsearch( const kdtree* t, const size_t node, const double* q, const size_t k, size_t* count, double* hd, size_t* hi )
+// collect the k nearest points to q in the subtree of node, using squared distances
+{
+  const kdnode* nd = &t->nodes[node];
+  const size_t p = t->p;
+  if ( nd->left == 0 ) {
+    for ( size_t j = nd->lo; j < nd->hi; j++ ) {
+      const double* __restrict y = &t->pts[j * p];
+      double sum = 0.0;
+      for ( size_t l = 0; l < p; l++ ) {
+        const double diff = q[l] - y[l];
+        sum += diff * diff;
+      }
+      heapinsert( k, count, hd, hi, sum, j );
+    }
+    return;
+  }
+  const double diff = q[nd->dim] - nd->split;
+  const size_t near = ( diff < 0.0 ? nd->left : nd->right );
+  const size_t far = ( diff < 0.0 ? nd->right : nd->left );
+  kdsearch( t, near, q, k, count, hd, hi );
+  if ( *count < k || diff * diff < hd[0] ) kdsearch( t, far, q, k, count, hd, hi );
+} // kdsearch
+
+void nearest( const size_t n, const size_t p, const double* x, const size_t m, const double* y, const size_t k, size_t* index, double* dist, const size_t nthreads )
+// Function nearest() finds, for each of the n rows of x, the k nearest rows of y (both row major, p columns),
+// index (n by k, 0-based) and dist (n by k) are sorted on increasing distance
+{
+  kdtree* t = newkdtree( m, p, y );
+
+#ifdef _OPENMP
+  const int nt = ( int )( nthreads < 1 ? 1 : nthreads );
+  #pragma omp parallel num_threads( nt ) if( nt > 1 )
+#endif
+  {
+    double* hd = ( double* ) calloc( k, sizeof( double ) );
+    size_t* hi = ( size_t* ) calloc( k, sizeof( size_t ) );
+
+#ifdef _OPENMP
+    #pragma omp for schedule( dynamic, 64 )
+#endif
+    for ( size_t i = 0; i < n; i++ ) {
+      size_t count = 0;
+      kdsearch( t, 0, &x[i * p], k, &count, hd, hi );
+
+      // heap sort: pop the largest into the last free position
+      for ( size_t c = count; c > 0; c-- ) {
+        index[i * k + c - 1] = t->perm[hi[0]];
+        dist[i * k + c - 1] = sqrt( hd[0] );
+        const double ld = hd[c - 1];
+        const size_t li = hi[c - 1];
+        size_t r = 0;
+        for ( ;; ) {
+          const size_t l = 2 * r + 1;
+          if ( l >= c - 1 ) break;
+          const size_t g = ( l + 1 < c - 1 && hd[l + 1] > hd[l] ? l + 1 : l );
+          if ( hd[g] <= ld ) break;
+          hd[r] = hd[g];
+          hi[r] = hi[g];
+          r = g;
+        }
+        hd[r] = ld;
+        hi[r] = li;
+      }
+    }
+
+    free( hd );
+    free( hi );
+  }
+
+  freekdtree( t );
+} // nearest
+
+void CRnearest( int* rn, int* rp, double* rx, int* rm, double* ry, int* rk, int* rindex, double* rdist, int* rnthreads )
+// Function CRnearest() finds the k nearest column points for each row point, returns 1-based indices
+{
+  const size_t n = *rn;
+  const size_t p = *rp;
+  const size_t m = *rm;
+  const size_t k = ( ( size_t )( *rk ) > m ? m : ( size_t )( *rk ) );
+  const size_t nthreads = ( *rnthreads < 1 ? 1 : ( size_t )( *rnthreads ) );
+  if ( n == 0 || m == 0 || k == 0 ) return;
+
+  size_t* index = ( size_t* ) calloc( n * k, sizeof( size_t ) );
+  nearest( n, p, rx, m, ry, k, index, rdist, nthreads );
+  for ( size_t i = 0; i < n * k; i++ ) rindex[i] = ( int )( index[i] + 1 );
+  free( index );
+} // CRnearest
@@ -6,8 +6,10 @@
 
 #include "fmdu.h"
 
-double mdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double mdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool lagged, fitcontrol* control, const bool echo )
 // Function mdu() performs multidimensional unfolding.
+// With lagged stress, the stress of the current configuration follows from the majorization identities
+// sigma = eta2( delta ) - 2 rho( X ) + eta2( X ), using B X from the update, and is explicitly evaluated only at the end.
 {
   const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
   const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
@@ -35,28 +37,17 @@ double mdu( const size_t n, const size_t m, double** delta, const size_t p, doub
   for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) nfy += fy[j][k];
 
   // update distances and calculate normalized stress
-  euclidean2( n, p, x, m, y, d );
-  double fold = 0.0;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      double work = delta[i][j] - d[i][j];
-      fold += work * work;
-    }
-  }
+  double fold = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start unfolding loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute original B and W matrices, based on Heiser (1989)
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -77,6 +68,43 @@ double mdu( const size_t n, const size_t m, double** delta, const size_t p, doub
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
+
+    // stress of the current configuration: rho( X ) = tr X'BX, eta2( X ) around the column centroid
+    if ( lagged == true && iter > firstiteration( control ) ) {
+      double rho = 0.0;
+      for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) rho += x[i][k] * xtilde[i][k];
+      for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) rho += y[j][k] * ytilde[j][k];
+      double eta2 = 0.0;
+      for ( size_t k = 1; k <= p; k++ ) {
+        double c = 0.0;
+        for ( size_t j = 1; j <= m; j++ ) c += y[j][k];
+        c /= wr;
+        double ssx = 0.0;
+        for ( size_t i = 1; i <= n; i++ ) ssx += ( x[i][k] - c ) * ( x[i][k] - c );
+        double ssy = 0.0;
+        for ( size_t j = 1; j <= m; j++ ) ssy += ( y[j][k] - c ) * ( y[j][k] - c );
+        eta2 += wr * ssx + wc * ssy;
+      }
+      fnew = ( scale - 2.0 * rho + eta2 ) / scale;
+
+      // record and echo intermediate results
+      traceiteration( control, echo, iter - 1, fold, fnew, n, m, d, TINY );
+
+      // check divergence and convergence of the previous update
+      ( *lastdif ) = fold - fnew;
+      if ( ( *lastdif ) <= -1.0 * CRIT ) break;
+      double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
+      if ( fdif <= FCRIT ) break;
+      fold = fnew;
+
+      // write checkpoint of the previous update when due
+      checkpoint( control, iter - 1, fold, n, m, p, x, y, 0, NULL, 0, NULL );
+
+      // stop when the time budget is exhausted
+      if ( outoftime( control ) ) break;
+    }
+    PROFILESTOP( control, PHASE.DISTANCE, ( lagged == true ? 4.0 * ( n + m ) * p : 0.0 ), ( lagged == true ? 32.0 * ( n + m ) * p : 0.0 ) );
 
     // configuration update: x and y
     for ( size_t i = 1; i <= n; i++ ) {
@@ -93,20 +121,20 @@ double mdu( const size_t n, const size_t m, double** delta, const size_t p, doub
         y[j][k] = upper / wc;
       }
     }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
-    // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
-    fnew = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += work * work;
-      }
+    // update distances and B matrix, and only with explicit stress also the normalized stress
+    if ( lagged == true ) {
+      fusedratios( n, p, x, m, y, delta, NULL, TINY, d, imb );
+      PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
+      continue;
     }
+    fnew = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check divergence and convergence
     ( *lastdif ) = fold - fnew;
@@ -114,9 +142,23 @@ double mdu( const size_t n, const size_t m, double** delta, const size_t p, doub
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, 0, NULL, 0, NULL );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
 
+  // lagged stress stops after testing the previous update: report explicitly evaluated stress
+  if ( lagged == true ) {
+    if ( iter <= MAXITER ) ( *lastiter ) = iter - 1;
+    fnew = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
+    fnew /= scale;
+  }
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
+
   // rotate to principal axes of x when no fixed coordinates are in play
   if ( nfx == 0 && nfy == 0 ) rotateplus( n, p, x, m, y );
 
@@ -128,7 +170,7 @@ double mdu( const size_t n, const size_t m, double** delta, const size_t p, doub
   return( fnew );
 } // mdu
 
-void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* rlagged, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Cmdu() performs multidimensional unfolding.
 {
   // transfer to C
@@ -148,12 +190,15 @@ void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, doub
   double** d = getmatrix( n, m, 0.0 );
   size_t MAXITER = *rmaxiter;
   double FCRIT = *rfdif;
+  bool lagged = ( *rlagged ) != 0;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = mdu( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = mdu( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, lagged, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
@@ -162,6 +207,9 @@ void Cmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, doub
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
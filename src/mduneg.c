@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double mduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double mduneg( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function mduneg() performs multidimensional unfolding allowing negative dissimilarities.
 {
   const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
@@ -49,12 +49,13 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start unfolding loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute original B and W matrices, based on Heiser (1989)
     for ( size_t i = 1; i <= n; i++ ) {
@@ -80,6 +81,7 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
       for ( size_t i = 1; i <= n; i++ ) work += imw[i][j];
       wc[j] = work;
     }
+    PROFILESTOP( control, PHASE.BMATRIX, 4.0 * n * m, 32.0 * n * m );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -100,6 +102,7 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // configuration update: x and y
     for ( size_t i = 1; i <= n; i++ ) {
@@ -118,6 +121,7 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
         if ( isnotzero( lower ) ) y[j][k] = upper / lower;
       }
     }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
     euclidean2( n, p, x, m, y, d );
@@ -129,9 +133,10 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
       }
     }
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -139,8 +144,15 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, 0, NULL, 0, NULL );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   if ( nfx == 0 && nfy == 0 ) rotateplus( n, p, x, m, y );
@@ -156,7 +168,7 @@ double mduneg( const size_t n, const size_t m, double** delta, const size_t p, d
   return( fnew );
 } // mduneg
 
-void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Cmduneg() performs multidimensional unfolding allowing negative dissimilarities.
 {
   // transfer to C
@@ -177,11 +189,13 @@ void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, d
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = mduneg( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = mduneg( n, m, delta, p, x, fx, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
@@ -190,6 +204,9 @@ void Cmduneg( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, d
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
@@ -6,14 +6,15 @@
 
 #include "fmdu.h"
 
-double pencolresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** b, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double pencolresmdu( const size_t n, const size_t m, double** delta, const size_t p, double** x, int** fx, const size_t h, double** q, double** qtq, double** b, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function pencolresmdu() performs penalized column restricted multidimensional unfolding.
+// qtq holds n q'q, which does not depend on the penalties and can be shared by the fits of a penalty path.
 {
   const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
   const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
   const double CRIT = sqrt( TOL );                                         // 0.00012207031250000000
   const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
-  const double INVTINY = 1.0 / TINY;
+  const size_t MAXINNER = 100;
 
   // allocate memory
   double** y = getmatrix( m, p, 0.0 );
@@ -22,23 +23,25 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
   double** ytilde = getmatrix( m, p, 0.0 );
   double** qtcq = getmatrix( h, h, 0.0 );
   double** hhh = getmatrix( h, h, 0.0 );
+  double* hb = getvector( h, 0.0 );
   double** hhn = getmatrix( h, n, 0.0 );
   double** hhp = getmatrix( h, p, 0.0 );
   double** hnp = getmatrix( n, p, 0.0 );
-  double* hh = getvector( h, 0.0 );
 
   // initialization
   double wr = ( double ) ( m );
-  double wc = ( double ) ( n );
-  for ( size_t i = 1; i <= h; i++ ) {
-    for ( size_t j = 1; j <= h; j++ ) {
-      double work = 0.0;
-      for ( size_t k = 1; k <= m; k++ ) work += q[k][i] * wc * q[k][j];
-      hhh[i][j] = qtcq[i][j] = work;
+  dcopy( h * h, &qtq[1][1], 1, &qtcq[1][1], 1 );
+  for ( size_t i = 1; i <= h; i++ ) qtcq[i][i] += rlambda;
+  const bool ridgeonly = ( llambda == 0.0 && glambda == 0.0 );
+  bool factored = false;
+  if ( ridgeonly == true ) {
+    dcopy( h * h, &qtcq[1][1], 1, &hhh[1][1], 1 );
+    factored = ( choldcmp( h, hhh ) == 0 );
+    if ( factored == false ) {
+      dcopy( h * h, &qtcq[1][1], 1, &hhh[1][1], 1 );
+      inverse( h, hhh );
     }
-    hhh[i][i] = qtcq[i][i] += rlambda;
   }
-  inverse( h, hhh );
   for ( size_t k = 1; k <= h; k++ ) {
     double work = 0.0;
     for ( size_t j = 1; j <= m; j++ ) work += q[j][k];
@@ -49,7 +52,6 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
 
   // update distances and calculate normalized stress
   dgemm( false, false, m, p, h, 1.0, q, b, 0.0, y );
-  euclidean2( n, p, x, m, y, d );
   double fridge = 0.0;
   double flasso = 0.0;
   double fgroup = 0.0;
@@ -61,25 +63,16 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
     fgroup += sqrt( work );
   }
   double fold = rlambda * fridge + llambda * flasso + glambda * fgroup;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      const double work = delta[i][j] - d[i][j];
-      fold += work * work;
-    }
-  }
+  fold += fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute B matrix
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -100,6 +93,7 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update x
     for ( size_t k = 1; k <= p; k++ ) {
@@ -111,32 +105,39 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
       for ( size_t j = 1; j <= p; j++ ) if ( fx[i][j] == 0 ) x[i][j] = ( xtilde[i][j] + hnp[i][j] ) / wr;
     }
 
-    // update b
-    for ( size_t i = 1; i <= h; i++ ) {
-      double work = 0.0;
-      for ( size_t j = 1; j <= p; j++ ) work += b[i][j] * b[i][j];
-      work = sqrt( work );
-      hh[i] = 0.5 * glambda * ( work < TINY ? INVTINY : 1.0 / work );
-    }
+    // update b: exact for ridge only, by the Cholesky factor of the constant system, otherwise block coordinate descent
+    // with soft-thresholding and group shrinkage
     dgemm( false, false, h, p, n, 1.0, hhn, x, 0.0, hhp );
-    dgemm( true, false, h, p, n, 1.0, q, ytilde, 1.0, hhp );
-    for ( size_t k = 1; k <= p; k++ ) {
-      dcopy( h * h, &qtcq[1][1], 1, &hhh[1][1], 1 );
-      for ( size_t i = 1; i <= h; i++ ) hhh[i][i] += 0.5 * llambda * ( fabs( b[i][k] ) < TINY ? INVTINY : 1.0 / fabs( b[i][k] ) );
-      for ( size_t i = 1; i <= h; i++ ) hhh[i][i] += hh[i];
-      inverse( h, hhh );
-      for ( size_t i = 1; i <= h; i++ ) {
-        double work = 0.0;
-        for ( size_t j = 1; j <= h; j++ ) work += hhh[i][j] * hhp[j][k];
-        b[i][k] = work;
+    dgemm( true, false, h, p, m, 1.0, q, ytilde, 1.0, hhp );
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * ( n + m ) * h * p + 2.0 * ( n + m ) * p, 8.0 * ( n + m ) * ( h + p ) + 24.0 * ( n + m ) * p );
+    size_t sweeps = 1;
+    if ( ridgeonly == true && factored == true ) {
+      for ( size_t k = 1; k <= p; k++ ) {
+        for ( size_t i = 1; i <= h; i++ ) hb[i] = hhp[i][k];
+        cholsolve( h, hhh, hb );
+        for ( size_t i = 1; i <= h; i++ ) b[i][k] = hb[i];
       }
     }
+    else if ( ridgeonly == true ) dgemm( false, false, h, p, h, 1.0, hhh, hhp, 0.0, b );
+    else sweeps = sglasso( h, p, qtcq, hhp, 0.5 * llambda, 0.5 * glambda, MAXINNER, TOL, b );
+    PROFILESTOP( control, PHASE.SOLVE, 2.0 * sweeps * h * h * p, 8.0 * sweeps * h * h );
 
-    // update y      
-    dgemm( false, false, m, p, h, 1.0, q, b, 0.0, y );
+    // update y from the nonzero rows of b
+    size_t nzrows = 0;
+    for ( size_t i = 1; i <= m; i++ ) for ( size_t k = 1; k <= p; k++ ) y[i][k] = 0.0;
+    for ( size_t j = 1; j <= h; j++ ) {
+      bool zero = true;
+      for ( size_t k = 1; k <= p; k++ ) if ( b[j][k] != 0.0 ) zero = false;
+      if ( zero == true ) continue;
+      nzrows++;
+      for ( size_t i = 1; i <= m; i++ ) {
+        const double qij = q[i][j];
+        for ( size_t k = 1; k <= p; k++ ) y[i][k] += qij * b[j][k];
+      }
+    }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * m * nzrows * p, 8.0 * m * nzrows + 8.0 * m * p );
 
     // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
     fridge = flasso = fgroup = 0.0;
     for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= p; j++ ) fridge += b[i][j] * b[i][j];
     for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= p; j++ ) flasso += fabs( b[i][j] );
@@ -146,15 +147,11 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
       fgroup += sqrt( work );
     }
     fnew = rlambda * fridge + llambda * flasso + glambda * fgroup;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += work * work;
-      }
-    }
+    fnew += fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew ); 
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -162,8 +159,15 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, 0, NULL, h, b );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   if ( nfx == 0 ) rotateplus( n, p, x, h, b );
@@ -178,13 +182,14 @@ double pencolresmdu( const size_t n, const size_t m, double** delta, const size_
   freematrix( hhn );
   freematrix( hhp );
   freematrix( hnp );
-  freevector( hh );
+  freevector( hb );
 
   return( fnew );
 } // pencolresmdu
 
-void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, int* rdesign, double* rb, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Ccolresmdu() performs column restricted multidimensional unfolding.
+// A valid design handle supplies q and its cross-product matrix, otherwise both are taken from rq.
 {
   // transfer to C
   size_t n = *rn;
@@ -198,21 +203,29 @@ void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int*
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) x[i][j] = rx[k];
   int** fx = getimatrix( n, p, 0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) fx[i][j] = rfx[k];
-  double** q = getmatrix( m, h, 0.0 );
-  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) q[i][j] = rq[k];
+  const design* dq = getdesign( rdesign );
+  if ( dq != NULL && ( dq->n != m || dq->h != h ) ) dq = NULL;
+  const bool owned = ( dq == NULL );
+  double** q = ( owned ? getmatrix( m, h, 0.0 ) : dq->q );
+  if ( owned ) for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) q[i][j] = rq[k];
   double** b = getmatrix( h, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
+  double** qtq = getmatrix( h, h, 0.0 );
+  if ( owned ) dgemm( true, false, h, h, m, ( double )( n ), q, q, 0.0, qtq );
+  else for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= h; j++ ) qtq[i][j] = ( double )( n ) * dq->cross[i][j];
   double** d = getmatrix( n, m, 0.0 );
   const double rlambda = *rrlambda;
   const double llambda = *rllambda;
   const double glambda = *rglambda;
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = pencolresmdu( n, m, delta, p, x, fx, h, q, b, d, rlambda, llambda, glambda, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = pencolresmdu( n, m, delta, p, x, fx, h, q, qtq, b, d, rlambda, llambda, glambda, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
@@ -222,13 +235,87 @@ void Cpencolresmdu( int* rn, int* rm, double* rdelta, int* rp, double* rx, int*
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
   freematrix( x );
   freeimatrix( fx );
-  freematrix( q );
+  if ( owned ) freematrix( q );
+  freematrix( qtq );
   freematrix( b );
   freematrix( d );
 
 } // Cpencolresmdu
+
+void Cpencolresmdupath( int* rn, int* rm, double* rdelta, int* rp, double* rx, int* rfx, int* rh, double* rq, double* rb, double* rd, int* rnlambda, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rpathb, double* rpathx, double* rfvalues, double* rnstress, int* rzeros, int* riters, int* rstatus, int* recho )
+// Function Cpencolresmdupath() performs penalized column restricted multidimensional unfolding for a sequence of penalty parameters.
+// Each fit starts from the coefficients and row coordinates of the previous fit, including its zero coefficients, and all fits share q'q.
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t h = *rh;
+  const size_t p = *rp;
+  const size_t nlambda = *rnlambda;
+  const size_t MAXITER = *rmaxiter;
+  double** delta = getmatrix( n, m, 0.0 );
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
+  double** x = getmatrix( n, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) x[i][j] = rx[k];
+  int** fx = getimatrix( n, p, 0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) fx[i][j] = rfx[k];
+  double** q = getmatrix( m, h, 0.0 );
+  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) q[i][j] = rq[k];
+  double** b = getmatrix( h, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
+  double** qtq = getmatrix( h, h, 0.0 );
+  dgemm( true, false, h, h, m, ( double )( n ), q, q, 0.0, qtq );
+  double** d = getmatrix( n, m, 0.0 );
+  const double FCRIT = *rfdif;
+  const bool echo = ( *recho ) != 0;
+  const double scale = dssq( n * m, &delta[1][1], 1 );
+
+  // run function
+  for ( size_t l = 0; l < nlambda; l++ ) {
+    fitcontrol control = setcontrol( NULL, 0, 0, 0.0 );
+    settrace( &control, NULL, 0, *recho );
+    size_t lastiter = 0;
+    double lastdif = 0.0;
+    rfvalues[l] = pencolresmdu( n, m, delta, p, x, fx, h, q, qtq, b, d, rrlambda[l], rllambda[l], rglambda[l], MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
+
+    // store the fit for this penalty
+    double stress = 0.0;
+    for ( size_t i = 1; i <= n; i++ ) {
+      for ( size_t j = 1; j <= m; j++ ) {
+        const double work = delta[i][j] - d[i][j];
+        stress += work * work;
+      }
+    }
+    rnstress[l] = ( scale > 0.0 ? stress / scale : 0.0 );
+    int zeros = 0;
+    for ( size_t i = 1; i <= h; i++ ) for ( size_t k = 1; k <= p; k++ ) if ( b[i][k] == 0.0 ) zeros++;
+    rzeros[l] = zeros;
+    riters[l] = ( int ) ( lastiter );
+    rstatus[l] = control.status;
+    for ( size_t j = 1, k = l * h * p; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rpathb[k] = b[i][j];
+    for ( size_t j = 1, k = l * n * p; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rpathx[k] = x[i][j];
+  }
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rx[k] = x[i][j];
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rb[k] = b[i][j];
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
+
+  // de-allocate memory
+  freematrix( delta );
+  freematrix( x );
+  freeimatrix( fx );
+  freematrix( q );
+  freematrix( qtq );
+  freematrix( b );
+  freematrix( d );
+
+} // Cpencolresmdupath
@@ -6,14 +6,15 @@
 
 #include "fmdu.h"
 
-double penrowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double penrowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** qtq, double** b, double** y, int** fy, double** d, const double rlambda, const double llambda, const double glambda, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function penrowresmdu() performs penalized row restricted multidimensional unfolding.
+// qtq holds m q'q, which does not depend on the penalties and can be shared by the fits of a penalty path.
 {
   const double EPS = DBL_EPSILON;                                          // 2.2204460492503131e-16
   const double TOL = sqrt( EPS );                                          // 1.4901161193847656e-08
   const double CRIT = sqrt( TOL );                                         // 0.00012207031250000000
   const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
-  const double INVTINY = 1.0 / TINY;
+  const size_t MAXINNER = 100;
 
   // allocate memory
   double** x = getmatrix( n, p, 0.0 );
@@ -22,21 +23,24 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
   double** ytilde = getmatrix( m, p, 0.0 );
   double** qtrq = getmatrix( h, h, 0.0 );
   double** hhh = getmatrix( h, h, 0.0 );
+  double* hb = getvector( h, 0.0 );
   double** hhm = getmatrix( h, m, 0.0 );
   double** hhp = getmatrix( h, p, 0.0 );
   double** hmp = getmatrix( m, p, 0.0 );
-  double* hh = getvector( h, 0.0 );
 
   // initialization
-  double wr = ( double ) ( m );
   double wc = ( double ) ( n );
-  for ( size_t i = 1; i <= h; i++ ) {
-    for ( size_t j = 1; j <= h; j++ ) {
-      double work = 0.0;
-      for ( size_t k = 1; k <= n; k++ ) work += q[k][i] * wr * q[k][j];
-      hhh[i][j] = qtrq[i][j] = work;
+  dcopy( h * h, &qtq[1][1], 1, &qtrq[1][1], 1 );
+  for ( size_t i = 1; i <= h; i++ ) qtrq[i][i] += rlambda;
+  const bool ridgeonly = ( llambda == 0.0 && glambda == 0.0 );
+  bool factored = false;
+  if ( ridgeonly == true ) {
+    dcopy( h * h, &qtrq[1][1], 1, &hhh[1][1], 1 );
+    factored = ( choldcmp( h, hhh ) == 0 );
+    if ( factored == false ) {
+      dcopy( h * h, &qtrq[1][1], 1, &hhh[1][1], 1 );
+      inverse( h, hhh );
     }
-    hhh[i][i] = qtrq[i][i] += rlambda;
   }
 
   for ( size_t k = 1; k <= h; k++ ) {
@@ -49,7 +53,6 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
 
   // update distances and calculate normalized stress
   dgemm( false, false, n, p, h, 1.0, q, b, 0.0, x );
-  euclidean2( n, p, x, m, y, d );
   double fridge = 0.0;
   double flasso = 0.0;
   double fgroup = 0.0;
@@ -61,25 +64,16 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
     fgroup += sqrt( work );
   }
   double fold = rlambda * fridge + llambda * flasso + glambda * fgroup;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      const double work = delta[i][j] - d[i][j];
-      fold += work * work;
-    }
-  }
+  fold += fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute B matrix
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and xtilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -100,31 +94,38 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
-    // update b
-    for ( size_t i = 1; i <= h; i++ ) {
-      double work = 0.0;
-      for ( size_t j = 1; j <= p; j++ ) work += b[i][j] * b[i][j];
-      work = sqrt( work );
-      hh[i] = 0.5 * glambda * ( work < TINY ? INVTINY : 1.0 / work );
-    }
+    // update b: exact for ridge only, by the Cholesky factor of the constant system, otherwise block coordinate descent
+    // with soft-thresholding and group shrinkage
     dgemm( false, false, h, p, m, 1.0, hhm, y, 0.0, hhp );
     dgemm( true, false, h, p, n, 1.0, q, xtilde, 1.0, hhp );
-    for ( size_t k = 1; k <= p; k++ ) {
-      dcopy( h * h, &qtrq[1][1], 1, &hhh[1][1], 1 );
-															 
-      for ( size_t i = 1; i <= h; i++ ) hhh[i][i] += 0.5 * llambda * ( fabs( b[i][k] ) < TINY ? INVTINY : 1.0 / fabs( b[i][k] ) );
-      for ( size_t i = 1; i <= h; i++ ) hhh[i][i] += hh[i];
-      inverse( h, hhh );
-      for ( size_t i = 1; i <= h; i++ ) {
-        double work = 0.0;
-        for ( size_t j = 1; j <= h; j++ ) work += hhh[i][j] * hhp[j][k];
-        b[i][k] = work;
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * ( n + m ) * h * p, 8.0 * ( n + m ) * ( h + p ) );
+    size_t sweeps = 1;
+    if ( ridgeonly == true && factored == true ) {
+      for ( size_t k = 1; k <= p; k++ ) {
+        for ( size_t i = 1; i <= h; i++ ) hb[i] = hhp[i][k];
+        cholsolve( h, hhh, hb );
+        for ( size_t i = 1; i <= h; i++ ) b[i][k] = hb[i];
       }
     }
+    else if ( ridgeonly == true ) dgemm( false, false, h, p, h, 1.0, hhh, hhp, 0.0, b );
+    else sweeps = sglasso( h, p, qtrq, hhp, 0.5 * llambda, 0.5 * glambda, MAXINNER, TOL, b );
+    PROFILESTOP( control, PHASE.SOLVE, 2.0 * sweeps * h * h * p, 8.0 * sweeps * h * h );
 
-    // update x      
-    dgemm( false, false, n, p, h, 1.0, q, b, 0.0, x );
+    // update x from the nonzero rows of b
+    size_t nzrows = 0;
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) x[i][k] = 0.0;
+    for ( size_t j = 1; j <= h; j++ ) {
+      bool zero = true;
+      for ( size_t k = 1; k <= p; k++ ) if ( b[j][k] != 0.0 ) zero = false;
+      if ( zero == true ) continue;
+      nzrows++;
+      for ( size_t i = 1; i <= n; i++ ) {
+        const double qij = q[i][j];
+        for ( size_t k = 1; k <= p; k++ ) x[i][k] += qij * b[j][k];
+      }
+    }
 
     // update y
     for ( size_t k = 1; k <= p; k++ ) {
@@ -135,9 +136,9 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
     for ( size_t i = 1; i <= m; i++ ) {
       for ( size_t j = 1; j <= p; j++ ) if ( fy[i][j] == 0 ) y[i][j] = ( ytilde[i][j] + hmp[i][j] ) / wc;
     }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * nzrows * p + 2.0 * ( n + m ) * p, 8.0 * n * nzrows + 24.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
     fridge = flasso = fgroup = 0.0;
     for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= p; j++ ) fridge += b[i][j] * b[i][j];
     for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= p; j++ ) flasso += fabs( b[i][j] );
@@ -147,15 +148,11 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
       fgroup += sqrt( work );
     }
     fnew = rlambda * fridge + llambda * flasso + glambda * fgroup;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += work * work;
-      }
-    }
+    fnew += fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew ); 
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -163,8 +160,15 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, h, b, 0, NULL );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // de-allocate memory
   freematrix( x );
@@ -176,13 +180,14 @@ double penrowresmdu( const size_t n, const size_t m, double** delta, const size_
   freematrix( hhm );
   freematrix( hhp );
   freematrix( hmp );
-  freevector( hh );
+  freevector( hb );
 
   return( fnew );
 } // penrowresmdu
 
-void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, int* rdesign, double* rb, double* ry, int* rfy, double* rd, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Cpenrowresmdu() performs penalized row restricted multidimensional unfolding.
+// A valid design handle supplies q and its cross-product matrix, otherwise both are taken from rq.
 {
   // transfer to C
   const size_t n = *rn;
@@ -192,25 +197,33 @@ void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double*
   const size_t MAXITER = *rmaxiter;
   double** delta = getmatrix( n, m, 0.0 );
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
-  double** q = getmatrix( n, h, 0.0 );
-  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
+  const design* dq = getdesign( rdesign );
+  if ( dq != NULL && ( dq->n != n || dq->h != h ) ) dq = NULL;
+  const bool owned = ( dq == NULL );
+  double** q = ( owned ? getmatrix( n, h, 0.0 ) : dq->q );
+  if ( owned ) for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
   double** b = getmatrix( h, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
   double** y = getmatrix( m, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) y[i][j] = ry[k];
   int** fy = getimatrix( m, p, 0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) fy[i][j] = rfy[k];
+  double** qtq = getmatrix( h, h, 0.0 );
+  if ( owned ) dgemm( true, false, h, h, n, ( double )( m ), q, q, 0.0, qtq );
+  else for ( size_t i = 1; i <= h; i++ ) for ( size_t j = 1; j <= h; j++ ) qtq[i][j] = ( double )( m ) * dq->cross[i][j];
   double** d = getmatrix( n, m, 0.0 );
   const double rlambda = *rrlambda;
   const double llambda = *rllambda;
   const double glambda = *rglambda;
   const double FCRIT = *rfdif;
   const bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = penrowresmdu( n, m, delta, p, h, q, b, y, fy, d, rlambda, llambda, glambda, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = penrowresmdu( n, m, delta, p, h, q, qtq, b, y, fy, d, rlambda, llambda, glambda, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rq[k] = q[i][j];
@@ -220,13 +233,87 @@ void Cpenrowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double*
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
-  freematrix( q );
+  if ( owned ) freematrix( q );
+  freematrix( qtq );
   freematrix( b );
   freematrix( y );
   freeimatrix( fy );
   freematrix( d );
 
 } // Cpenrowresmdu
+
+void Cpenrowresmdupath( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rnlambda, double* rrlambda, double* rllambda, double* rglambda, int* rmaxiter, double* rfdif, double* rpathb, double* rpathy, double* rfvalues, double* rnstress, int* rzeros, int* riters, int* rstatus, int* recho )
+// Function Cpenrowresmdupath() performs penalized row restricted multidimensional unfolding for a sequence of penalty parameters.
+// Each fit starts from the coefficients and column coordinates of the previous fit, including its zero coefficients, and all fits share q'q.
+{
+  // transfer to C
+  const size_t n = *rn;
+  const size_t m = *rm;
+  const size_t h = *rh;
+  const size_t p = *rp;
+  const size_t nlambda = *rnlambda;
+  const size_t MAXITER = *rmaxiter;
+  double** delta = getmatrix( n, m, 0.0 );
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
+  double** q = getmatrix( n, h, 0.0 );
+  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
+  double** b = getmatrix( h, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
+  double** y = getmatrix( m, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) y[i][j] = ry[k];
+  int** fy = getimatrix( m, p, 0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) fy[i][j] = rfy[k];
+  double** qtq = getmatrix( h, h, 0.0 );
+  dgemm( true, false, h, h, n, ( double )( m ), q, q, 0.0, qtq );
+  double** d = getmatrix( n, m, 0.0 );
+  const double FCRIT = *rfdif;
+  const bool echo = ( *recho ) != 0;
+  const double scale = dssq( n * m, &delta[1][1], 1 );
+
+  // run function
+  for ( size_t l = 0; l < nlambda; l++ ) {
+    fitcontrol control = setcontrol( NULL, 0, 0, 0.0 );
+    settrace( &control, NULL, 0, *recho );
+    size_t lastiter = 0;
+    double lastdif = 0.0;
+    rfvalues[l] = penrowresmdu( n, m, delta, p, h, q, qtq, b, y, fy, d, rrlambda[l], rllambda[l], rglambda[l], MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
+
+    // store the fit for this penalty
+    double stress = 0.0;
+    for ( size_t i = 1; i <= n; i++ ) {
+      for ( size_t j = 1; j <= m; j++ ) {
+        const double work = delta[i][j] - d[i][j];
+        stress += work * work;
+      }
+    }
+    rnstress[l] = ( scale > 0.0 ? stress / scale : 0.0 );
+    int zeros = 0;
+    for ( size_t i = 1; i <= h; i++ ) for ( size_t k = 1; k <= p; k++ ) if ( b[i][k] == 0.0 ) zeros++;
+    rzeros[l] = zeros;
+    riters[l] = ( int ) ( lastiter );
+    rstatus[l] = control.status;
+    for ( size_t j = 1, k = l * h * p; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rpathb[k] = b[i][j];
+    for ( size_t j = 1, k = l * m * p; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) rpathy[k] = y[i][j];
+  }
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rb[k] = b[i][j];
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) ry[k] = y[i][j];
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
+
+  // de-allocate memory
+  freematrix( delta );
+  freematrix( q );
+  freematrix( qtq );
+  freematrix( b );
+  freematrix( y );
+  freeimatrix( fy );
+  freematrix( d );
+
+} // Cpenrowresmdupath
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include <limits.h>
+#include <time.h>
+
+#include "registry.h"
+
+static int lasttoken = 0;
+
+static int newtoken( void )
+// Function newtoken() returns the next generation token, shared by all registries, starting from a time dependent value per session.
+{
+  if ( lasttoken == 0 ) lasttoken = ( int )( ( ( unsigned int )( time( NULL ) ) * 2654435761u ) >> 1 );
+  lasttoken = ( lasttoken == INT_MAX ? 1 : lasttoken + 1 );
+  return lasttoken;
+} // newtoken
+
+int newhandle( registry* r, void* item, int* handle )
+// Function newhandle() registers item in the first free slot and returns 0 with its handle { id, token }, or -1 with { -1, 0 } when full.
+{
+  handle[0] = -1;
+  handle[1] = 0;
+  size_t id = 0;
+  while ( id < MAXHANDLES && r->items[id] != NULL ) id++;
+  if ( id == MAXHANDLES ) return -1;
+  r->items[id] = item;
+  r->tokens[id] = newtoken( );
+  handle[0] = ( int )( id );
+  handle[1] = r->tokens[id];
+  return 0;
+} // newhandle
+
+void* gethandle( const registry* r, const int* handle )
+// Function gethandle() returns the object with handle { id, token }, or NULL for an unused or stale handle.
+{
+  const int id = handle[0];
+  if ( id < 0 || id >= MAXHANDLES || r->items[id] == NULL || r->tokens[id] != handle[1] ) return NULL;
+  return r->items[id];
+} // gethandle
+
+void* releasehandle( registry* r, const int* handle )
+// Function releasehandle() frees the slot of handle { id, token } and returns its object for the caller to release, or NULL for a stale handle.
+{
+  void* item = gethandle( r, handle );
+  if ( item == NULL ) return NULL;
+  r->items[handle[0]] = NULL;
+  r->tokens[handle[0]] = 0;
+  return item;
+} // releasehandle
@@ -0,0 +1,28 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <stddef.h>
+
+// registry: objects held in C memory on behalf of R, such as designs, scorers, and online data, identified by a handle
+// { id, token } with the slot number and a generation token. A slot is reused after its object is released, but its token
+// is not, and the first token of a session depends on the time, so that a handle to a released object, or one restored
+// from an earlier session, no longer matches instead of silently pointing to another object.
+
+#define MAXHANDLES 256
+
+typedef struct registry_struct {
+  void* items[MAXHANDLES];   // registered objects, NULL for a free slot
+  int tokens[MAXHANDLES];    // generation token per slot, 0 for a free slot
+} registry;
+
+extern int newhandle( registry* r, void* item, int* handle );
+extern void* gethandle( const registry* r, const int* handle );
+extern void* releasehandle( registry* r, const int* handle );
+
+#endif
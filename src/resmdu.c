@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double resmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double resmdu( const size_t n, const size_t m, double** delta, const size_t p, const design* dx, double** bx, const design* dy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function resmdu() performs restricted multidimensional unfolding.
 {
   const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
@@ -14,19 +14,20 @@ double resmdu( const size_t n, const size_t m, double** delta, const size_t p, c
   const double CRIT = sqrt( TOL );                                             // 0.00012207031250000000
   const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
 
+  // designs: independent variables, inverse cross-product matrices, and column sums
+  const size_t hx = dx->h;
+  double** qx = dx->q;
+  const size_t hy = dy->h;
+  double** qy = dy->q;
+
   // allocate memory
   double** x = getmatrix( n, p, 0.0 );
   double** y = getmatrix( m, p, 0.0 );
   double** imb = getmatrix( n, m, 0.0 );
   double** xtilde = getmatrix( n, p, 0.0 );
   double** ytilde = getmatrix( m, p, 0.0 );
-  double** hxx = getmatrix( hx, hx, 0.0 );
-  double** hhm = getmatrix( hx, m, 0.0 );
-  double** hhp = getmatrix( hx, p, 0.0 );
-  double** hmp = getmatrix( m, p, 0.0 );
-  double** hyy = getmatrix( hy, hy, 0.0 );
-  double** hhn = getmatrix( hy, m, 0.0 );
-  double** hnp = getmatrix( m, p, 0.0 );
+  double** hxp = getmatrix( hx, p, 0.0 );
+  double** hyp = getmatrix( hy, p, 0.0 );
 
   // initialization
   double wr = ( double ) ( m );
@@ -38,59 +39,21 @@ double resmdu( const size_t n, const size_t m, double** delta, const size_t p, c
       scale += work * work;
     }
   }
-  for ( size_t i = 1; i <= hx; i++ ) {
-    for ( size_t j = 1; j <= hx; j++ ) {
-      double work = 0.0;
-      for ( size_t k = 1; k <= n; k++ ) work += qx[k][i] * wr * qx[k][j];
-      hxx[i][j] = work;
-    }
-  }
-  inverse( hx, hxx );
-  for ( size_t k = 1; k <= hx; k++ ) {
-    double work = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) work += qx[i][k];
-    for ( size_t j = 1; j <= m; j++ ) hhm[k][j] = work;
-  }
-
-  for ( size_t i = 1; i <= hy; i++ ) {
-    for ( size_t j = 1; j <= hy; j++ ) {
-      double work = 0.0;
-      for ( size_t k = 1; k <= m; k++ ) work += qy[k][i] * wc * qy[k][j];
-      hyy[i][j] = work;
-    }
-  }
-  inverse( hy, hyy );
-  for ( size_t k = 1; k <= hy; k++ ) {
-    double work = 0.0;
-    for ( size_t j = 1; j <= m; j++ ) work += qy[j][k];
-    for ( size_t i = 1; i <= n; i++ ) hhn[k][i] = work;
-  }
 
   // update distances and calculate normalized stress
   dgemm( false, false, n, p, hx, 1.0, qx, bx, 0.0, x );
   dgemm( false, false, m, p, hy, 1.0, qy, by, 0.0, y );
-  euclidean2( n, p, x, m, y, d );
-  double fold = 0.0;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      const double work = delta[i][j] - d[i][j];
-      fold += work * work;
-    }
-  }
+  double fold = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute B matrix
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -111,48 +74,40 @@ double resmdu( const size_t n, const size_t m, double** delta, const size_t p, c
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update bx
-    dgemm( false, false, hx, p, m, 1.0, hhm, y, 0.0, hhp );
-    for ( size_t i = 1; i <= hx; i++ ) {
-      for ( size_t j = 1; j <= p; j++ ) {
-        double work = 0.0;
-        for ( size_t k = 1; k <= n; k++ ) work += qx[k][i] * xtilde[k][j];
-        hhp[i][j] += work;
-      }
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t j = 1; j <= m; j++ ) work += y[j][k];
+      for ( size_t i = 1; i <= hx; i++ ) hxp[i][k] = dx->sums[i] * work;
     }
-    dgemm( false, false, hx, p, hx, 1.0, hxx, hhp, 0.0, bx );
+    dgemm( true, false, hx, p, n, 1.0, qx, xtilde, 1.0, hxp );
+    dgemm( false, false, hx, p, hx, 1.0 / wr, dx->inv, hxp, 0.0, bx );
 
     // update x
     dgemm( false, false, n, p, hx, 1.0, qx, bx, 0.0, x );
 
     // update by
-    dgemm( false, false, hy, p, n, 1.0, hhn, x, 0.0, hhp );
-    for ( size_t i = 1; i <= hy; i++ ) {
-      for ( size_t j = 1; j <= p; j++ ) {
-        double work = 0.0;
-        for ( size_t k = 1; k <= m; k++ ) work += qy[k][i] * ytilde[k][j];
-        hhp[i][j] += work;
-      }
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t i = 1; i <= n; i++ ) work += x[i][k];
+      for ( size_t i = 1; i <= hy; i++ ) hyp[i][k] = dy->sums[i] * work;
     }
-    dgemm( false, false, hy, p, hy, 1.0, hyy, hhp, 0.0, by );
+    dgemm( true, false, hy, p, m, 1.0, qy, ytilde, 1.0, hyp );
+    dgemm( false, false, hy, p, hy, 1.0 / wc, dy->inv, hyp, 0.0, by );
 
     // update y
     dgemm( false, false, m, p, hy, 1.0, qy, by, 0.0, y );
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
-    fnew = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += work * work;
-      }
-    }
+    fnew = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -160,8 +115,15 @@ double resmdu( const size_t n, const size_t m, double** delta, const size_t p, c
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, hx, bx, hy, by );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   rotateplusplus( n, p, x, hx, bx, hy, by );
@@ -172,18 +134,13 @@ double resmdu( const size_t n, const size_t m, double** delta, const size_t p, c
   freematrix( imb );
   freematrix( xtilde );
   freematrix( ytilde );
-  freematrix( hxx );
-  freematrix( hhm );
-  freematrix( hhp );
-  freematrix( hmp );
-  freematrix( hyy );
-  freematrix( hhn );
-  freematrix( hnp );
+  freematrix( hxp );
+  freematrix( hyp );
 
   return( fnew );
 } // resmdu
 
-void Cresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, int* rdesignx, double* rbx, int* rhy, double* rqy, int* rdesigny, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Crowresmdu() performs row restricted multidimensional unfolding.
 {
   // transfer to C
@@ -195,38 +152,55 @@ void Cresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx,
   size_t MAXITER = *rmaxiter;
   double** delta = getmatrix( n, m, 0.0 );
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
-  double** qx = getmatrix( n, hx, 0.0 );
-  for ( size_t j = 1, k = 0; j <= hx; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) qx[i][j] = rqx[k];
+  design* dx = getdesign( rdesignx );
+  if ( dx != NULL && ( dx->n != n || dx->h != hx ) ) dx = NULL;
+  const bool ownedx = ( dx == NULL );
+  if ( ownedx ) {
+    double** qx = getmatrix( n, hx, 0.0 );
+    for ( size_t j = 1, k = 0; j <= hx; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) qx[i][j] = rqx[k];
+    dx = newdesign( n, hx, qx );
+    freematrix( qx );
+  }
   double** bx = getmatrix( hx, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= hx; i++, k++ ) bx[i][j] = rbx[k];
-  double** qy = getmatrix( n, hy, 0.0 );
-  for ( size_t j = 1, k = 0; j <= hy; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) qy[i][j] = rqy[k];
+  design* dy = getdesign( rdesigny );
+  if ( dy != NULL && ( dy->n != m || dy->h != hy ) ) dy = NULL;
+  const bool ownedy = ( dy == NULL );
+  if ( ownedy ) {
+    double** qy = getmatrix( m, hy, 0.0 );
+    for ( size_t j = 1, k = 0; j <= hy; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) qy[i][j] = rqy[k];
+    dy = newdesign( m, hy, qy );
+    freematrix( qy );
+  }
   double** by = getmatrix( hy, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= hy; i++, k++ ) by[i][j] = rby[k];
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = resmdu( n, m, delta, p, hx, qx, bx, hy, qy, by, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = resmdu( n, m, delta, p, dx, bx, dy, by, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
-  for ( size_t j = 1, k = 0; j <= hx; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rqx[k] = qx[i][j];
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= hx; i++, k++ ) rbx[k] = bx[i][j];
-  for ( size_t j = 1, k = 0; j <= hy; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rqy[k] = qy[i][j];
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= hy; i++, k++ ) rby[k] = by[i][j];
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
-  freematrix( qx );
+  if ( ownedx ) freedesign( dx );
   freematrix( bx );
-  freematrix( qy );
+  if ( ownedy ) freedesign( dy );
   freematrix( by );
   freematrix( d );
 
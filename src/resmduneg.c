@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double resmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double resmduneg( const size_t n, const size_t m, double** delta, const size_t p, const size_t hx, double** qx, double** bx, const size_t hy, double** qy, double** by, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function resmduneg() performs row restricted multidimensional unfolding.
 {
   const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
@@ -56,12 +56,13 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute original B and W matrices, based on Heiser (1989)
     for ( size_t i = 1; i <= n; i++ ) {
@@ -87,6 +88,7 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
       for ( size_t i = 1; i <= n; i++ ) work += imw[i][j];
       wc[j] = work;
     }
+    PROFILESTOP( control, PHASE.BMATRIX, 4.0 * n * m, 32.0 * n * m );
 
     // compute preliminary updates: xtilde and ytilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -107,6 +109,7 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update bx
     for ( size_t i = 1; i <= hx; i++ ) {
@@ -153,6 +156,7 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
 
     // update y
     dgemm( false, false, m, p, hy, 1.0, qy, by, 0.0, y );
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
     euclidean2( n, p, x, m, y, d );
@@ -164,9 +168,10 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
       }
     }
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -174,8 +179,15 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, hx, bx, hy, by );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   rotateplusplus( n, p, x, hx, bx, hy, by );
@@ -200,7 +212,7 @@ double resmduneg( const size_t n, const size_t m, double** delta, const size_t p
   return( fnew );
 } // resmduneg
 
-void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rqx, double* rbx, int* rhy, double* rqy, double* rby, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Cresmduneg() performs row restricted multidimensional unfolding.
 {
   // transfer to C
@@ -223,11 +235,13 @@ void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rq
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = resmduneg( n, m, delta, p, hx, qx, bx, hy, qy, by, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = resmduneg( n, m, delta, p, hx, qx, bx, hy, qy, by, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
   for ( size_t j = 1, k = 0; j <= hx; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rqx[k] = qx[i][j];
@@ -238,6 +252,9 @@ void Cresmduneg( int* rn, int* rm, double* rdelta, int* rp, int* rhx, double* rq
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
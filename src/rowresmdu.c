@@ -6,7 +6,7 @@
 
 #include "fmdu.h"
 
-double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, double** q, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, const bool echo )
+double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const design* dq, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
 // Function rowresmdu() performs row restricted weighted multidimensional unfolding.
 {
   const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
@@ -14,13 +14,15 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
   const double CRIT = sqrt( TOL );                                             // 0.00012207031250000000
   const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
 
+  // design: independent variables, inverse cross-product matrix, and column sums
+  const size_t h = dq->h;
+  double** q = dq->q;
+
   // allocate memory
   double** x = getmatrix( n, p, 0.0 );
   double** imb = getmatrix( n, m, 0.0 );
   double** xtilde = getmatrix( n, p, 0.0 );
   double** ytilde = getmatrix( m, p, 0.0 );
-  double** hhh = getmatrix( h, h, 0.0 );
-  double** hhm = getmatrix( h, m, 0.0 );
   double** hhp = getmatrix( h, p, 0.0 );
   double** hmp = getmatrix( m, p, 0.0 );
 
@@ -34,46 +36,22 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
       scale += work * work;
     }
   }
-  for ( size_t i = 1; i <= h; i++ ) {
-    for ( size_t j = 1; j <= h; j++ ) {
-      double work = 0.0;
-      for ( size_t k = 1; k <= n; k++ ) work += q[k][i] * wr * q[k][j];
-      hhh[i][j] = work;
-    }
-  }
-  inverse( h, hhh );
-  for ( size_t k = 1; k <= h; k++ ) {
-    double work = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) work += q[i][k];
-    for ( size_t j = 1; j <= m; j++ ) hhm[k][j] = work;
-  }
   int nfy = 0;
   for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) nfy += fy[j][k];
 
   // update distances and calculate normalized stress
   dgemm( false, false, n, p, h, 1.0, q, b, 0.0, x );
-  euclidean2( n, p, x, m, y, d );
-  double fold = 0.0;
-  for ( size_t i = 1; i <= n; i++ ) {
-    for ( size_t j = 1; j <= m; j++ ) {
-      const double work = delta[i][j] - d[i][j];
-      fold += work * work;
-    }
-  }
+  double fold = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
   fold /= scale;
   double fnew = 0.0;
 
-  // echo intermediate results
-  if ( echo == true ) echoprogress( 0, fold, fold, fold );
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
 
   // start main loop
   size_t iter = 0;
-  for ( iter = 1; iter <= MAXITER; iter++ ) {
-
-    // compute B matrix
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) imb[i][j] = ( d[i][j] < TINY ? 0.0 : delta[i][j] / d[i][j] );
-    }
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
 
     // compute preliminary updates: xtilde and xtilde
     for ( size_t i = 1; i <= n; i++ ) {
@@ -94,17 +72,16 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
         ytilde[i][j] = csb * y[i][j] - work;
       }
     }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
 
     // update b
-    dgemm( false, false, h, p, m, 1.0, hhm, y, 0.0, hhp );
-    for ( size_t i = 1; i <= h; i++ ) {
-      for ( size_t j = 1; j <= p; j++ ) {
-        double work = 0.0;
-        for ( size_t k = 1; k <= n; k++ ) work += q[k][i] * xtilde[k][j];
-        hhp[i][j] += work;
-      }
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t j = 1; j <= m; j++ ) work += y[j][k];
+      for ( size_t i = 1; i <= h; i++ ) hhp[i][k] = dq->sums[i] * work;
     }
-    dgemm( false, false, h, p, h, 1.0, hhh, hhp, 0.0, b );
+    dgemm( true, false, h, p, n, 1.0, q, xtilde, 1.0, hhp );
+    dgemm( false, false, h, p, h, 1.0 / wr, dq->inv, hhp, 0.0, b );
 
     // update x
     dgemm( false, false, n, p, h, 1.0, q, b, 0.0, x );
@@ -118,20 +95,15 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
     for ( size_t i = 1; i <= m; i++ ) {
       for ( size_t j = 1; j <= p; j++ ) if ( fy[i][j] == 0 ) y[i][j] = ( ytilde[i][j] + hmp[i][j] ) / wc;
     }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
 
     // update distances and calculate normalized stress
-    euclidean2( n, p, x, m, y, d );
-    fnew = 0.0;
-    for ( size_t i = 1; i <= n; i++ ) {
-      for ( size_t j = 1; j <= m; j++ ) {
-        double work = delta[i][j] - d[i][j];
-        fnew += work * work;
-      }
-    }
+    fnew = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
     fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
 
-    // echo intermediate results
-    if ( echo == true ) echoprogress( iter, fold, fold, fnew );
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
 
     // check convergence
     ( *lastdif ) = fold - fnew;
@@ -139,8 +111,15 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
     double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
     if ( fdif <= FCRIT ) break;
     fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, h, b, 0, NULL );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
   }
   ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
 
   // rotate to principal axes of x
   if ( nfy == 0 ) rotateplusplus( n, p, x, h, b, m, y );
@@ -150,15 +129,13 @@ double rowresmdu( const size_t n, const size_t m, double** delta, const size_t p
   freematrix( imb );
   freematrix( xtilde );
   freematrix( ytilde );
-  freematrix( hhh );
-  freematrix( hhm );
   freematrix( hhp );
   freematrix( hmp );
 
   return( fnew );
 } // rowresmdu
 
-void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, int* recho )
+void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq, int* rdesign, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
 // Function Crowresmdu() performs row restricted weighted multidimensional unfolding.
 {
   // transfer to C
@@ -169,8 +146,15 @@ void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq,
   size_t MAXITER = *rmaxiter;
   double** delta = getmatrix( n, m, 0.0 );
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
-  double** q = getmatrix( n, h, 0.0 );
-  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
+  design* dq = getdesign( rdesign );
+  if ( dq != NULL && ( dq->n != n || dq->h != h ) ) dq = NULL;
+  const bool owned = ( dq == NULL );
+  if ( owned ) {
+    double** q = getmatrix( n, h, 0.0 );
+    for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) q[i][j] = rq[k];
+    dq = newdesign( n, h, q );
+    freematrix( q );
+  }
   double** b = getmatrix( h, p, 0.0 );
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
   double** y = getmatrix( m, p, 0.0 );
@@ -180,24 +164,28 @@ void Crowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, double* rq,
   double** d = getmatrix( n, m, 0.0 );
   double FCRIT = *rfdif;
   bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
 
   // run function
   size_t lastiter = 0;
   double lastdif = 0.0;
-  double fvalue = rowresmdu( n, m, delta, p, h, q, b, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, echo );
+  double fvalue = rowresmdu( n, m, delta, p, dq, b, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
 
   // transfer to R
-  for ( size_t j = 1, k = 0; j <= h; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rq[k] = q[i][j];
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rb[k] = b[i][j];
   for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) ry[k] = y[i][j];
   for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
   ( *rmaxiter ) = ( int ) ( lastiter );
   ( *rfdif ) = lastdif;
   ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
 
   // de-allocate memory
   freematrix( delta );
-  freematrix( q );
+  if ( owned ) freedesign( dq );
   freematrix( b );
   freematrix( y );
   freeimatrix( fy );
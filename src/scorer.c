@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "scorer.h"
+#include "registry.h"
+
+static size_t padded( const size_t n )
+// round n up to a whole number of aligned blocks
+{
+  const size_t unit = SCORERALIGN / sizeof( double );
+  return ( ( n + unit - 1 ) / unit ) * unit;
+} // padded
+
+scorer* newscorer( const size_t m, const size_t p, const double* fixed, const size_t MAXITER, const double FCRIT )
+// Function newscorer() creates a scorer for the m by p fixed configuration (row major).
+{
+  if ( m == 0 || p == 0 || fixed == NULL ) return NULL;
+  scorer* s = ( scorer* ) calloc( 1, sizeof( scorer ) );
+  if ( s == NULL ) return NULL;
+  s->m = m;
+  s->p = p;
+  s->mpad = padded( m );
+  s->MAXITER = MAXITER;
+  s->FCRIT = FCRIT;
+
+  // one block: fixed, norms, dwork, b, d (all mpad aligned), sums and fw
+  const size_t ndoubles = ( p + 4 ) * s->mpad + 2 * padded( p );
+  s->block = malloc( ndoubles * sizeof( double ) + SCORERALIGN );
+  if ( s->block == NULL ) {
+    free( s );
+    return NULL;
+  }
+  const uintptr_t offset = ( uintptr_t )( s->block ) % SCORERALIGN;
+  double* base = ( double* )( ( char* )( s->block ) + ( offset == 0 ? 0 : SCORERALIGN - offset ) );
+  memset( base, 0, ndoubles * sizeof( double ) );
+  s->fixed = base;
+  s->norms = s->fixed + p * s->mpad;
+  s->dwork = s->norms + s->mpad;
+  s->b = s->dwork + s->mpad;
+  s->d = s->b + s->mpad;
+  s->sums = s->d + s->mpad;
+  s->fw = s->sums + padded( p );
+
+  // transpose to dimension major, squared norms and column sums
+  for ( size_t j = 0; j < m; j++ ) {
+    double nrm = 0.0;
+    for ( size_t k = 0; k < p; k++ ) {
+      const double f = fixed[j * p + k];
+      s->fixed[k * s->mpad + j] = f;
+      s->sums[k] += f;
+      nrm += f * f;
+    }
+    s->norms[j] = nrm;
+  }
+  return s;
+} // newscorer
+
+void freescorer( scorer* s )
+// Function freescorer() releases a scorer.
+{
+  if ( s == NULL ) return;
+  free( s->block );
+  free( s );
+} // freescorer
+
+static void distances( const scorer* s, const double* z, const double zz, double* d )
+// distances between z and all fixed points: sqrt( |z|^2 + |f|^2 - 2 z'f ), refined directly when cancellation occurs
+{
+  const double TOL = sqrt( DBL_EPSILON );
+  const size_t m = s->m;
+  const size_t p = s->p;
+  const size_t mpad = s->mpad;
+  for ( size_t j = 0; j < m; j++ ) d[j] = 0.0;
+  for ( size_t k = 0; k < p; k++ ) {
+    const double zk = -2.0 * z[k];
+    const double* __restrict fk = &s->fixed[k * mpad];
+    for ( size_t j = 0; j < m; j++ ) d[j] += zk * fk[j];
+  }
+  for ( size_t j = 0; j < m; j++ ) {
+    const double d2 = d[j] + zz + s->norms[j];
+    if ( d2 > TOL * ( zz + s->norms[j] ) ) d[j] = sqrt( d2 );
+    else {
+      double sum = 0.0;
+      for ( size_t k = 0; k < p; k++ ) {
+        const double diff = z[k] - s->fixed[k * mpad + j];
+        sum += diff * diff;
+      }
+      d[j] = sqrt( sum );
+    }
+  }
+} // distances
+
+double scoreobject( scorer* s, const double* delta, const double* w, double* z, double* dist, size_t* lastiter )
+// Function scoreobject() performs external unfolding for one object with dissimilarities delta (m) and optional weights w (m).
+// z (p) holds the initial coordinates, all zero for a probability weighted start, and receives the final coordinates.
+// dist (m), if not NULL, receives the final distances; lastiter, if not NULL, the number of iterations.
+{
+  const double EPS = DBL_EPSILON;   // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );   // 1.4901161193847656e-08
+  const double CRIT = sqrt( TOL );  // 0.00012207031250000000
+  const size_t m = s->m;
+  const size_t p = s->p;
+  const size_t mpad = s->mpad;
+  double* __restrict dwork = s->dwork;
+  double* __restrict b = s->b;
+  double* __restrict d = s->d;
+
+  // work with temporary delta, weight sums
+  double sumw = 0.0;
+  double scale = 0.0;
+  for ( size_t j = 0; j < m; j++ ) {
+    const double wj = ( w == NULL ? 1.0 : w[j] );
+    dwork[j] = delta[j];
+    sumw += wj;
+    scale += wj * delta[j] * delta[j];
+  }
+  if ( sumw <= 0.0 ) return 0.0;
+  if ( scale <= 0.0 ) scale = 1.0;
+  for ( size_t k = 0; k < p; k++ ) {
+    if ( w == NULL ) s->fw[k] = s->sums[k];
+    else {
+      double work = 0.0;
+      const double* __restrict fk = &s->fixed[k * mpad];
+      for ( size_t j = 0; j < m; j++ ) work += w[j] * fk[j];
+      s->fw[k] = work;
+    }
+  }
+
+  // initial z: probability weighted average, see pdist() in external.c
+  double zz = 0.0;
+  for ( size_t k = 0; k < p; k++ ) zz += z[k] * z[k];
+  if ( zz == 0.0 ) {
+    double sm = ( double )( m ) * TOL;
+    for ( size_t j = 0; j < m; j++ ) sm += dwork[j];
+    double alpha = 0.0;
+    for ( size_t j = 0; j < m; j++ ) {
+      b[j] = sm / ( dwork[j] + TOL );
+      alpha += b[j];
+    }
+    if ( alpha == 0.0 ) alpha = TOL;
+    for ( size_t k = 0; k < p; k++ ) {
+      double work = 0.0;
+      const double* __restrict fk = &s->fixed[k * mpad];
+      for ( size_t j = 0; j < m; j++ ) work += b[j] * fk[j];
+      z[k] = work / alpha;
+      zz += z[k] * z[k];
+    }
+  }
+
+  // administration: distances and function value, as wrmse() in external()
+  distances( s, z, zz, d );
+  double fold = 0.0;
+  for ( size_t j = 0; j < m; j++ ) {
+    const double r = dwork[j] - d[j];
+    fold += ( w == NULL ? 1.0 : w[j] ) * r * r;
+  }
+  fold = sqrt( fold ) / scale;
+  double fnew = fold;
+
+  // algorithm loop
+  size_t iter = 0;
+  for ( iter = 1; iter <= s->MAXITER; iter++ ) {
+
+    // scale delta
+    double lower = 0.0;
+    double upper = 0.0;
+    for ( size_t j = 0; j < m; j++ ) {
+      lower += ( w == NULL ? 1.0 : w[j] ) * dwork[j] * dwork[j];
+      upper += dwork[j] * d[j];
+    }
+    const double alpha = ( lower < DBL_EPSILON ? 1.0 : upper / lower );
+    for ( size_t j = 0; j < m; j++ ) dwork[j] *= alpha;
+
+    // update configuration
+    double pi = 0.0;
+    for ( size_t j = 0; j < m; j++ ) {
+      b[j] = ( d[j] != 0.0 ? ( w == NULL ? 1.0 : w[j] ) * dwork[j] / d[j] : 0.0 );
+      pi += b[j];
+    }
+
+    // update: xtilde
+    zz = 0.0;
+    for ( size_t k = 0; k < p; k++ ) {
+      double by = 0.0;
+      const double* __restrict fk = &s->fixed[k * mpad];
+      for ( size_t j = 0; j < m; j++ ) by += b[j] * fk[j];
+      z[k] = ( pi * z[k] - by + s->fw[k] ) / sumw;
+      zz += z[k] * z[k];
+    }
+
+    // administration
+    distances( s, z, zz, d );
+    fnew = 0.0;
+    for ( size_t j = 0; j < m; j++ ) {
+      const double r = dwork[j] - d[j];
+      fnew += ( w == NULL ? 1.0 : w[j] ) * r * r;
+    }
+    fnew = sqrt( fnew ) / scale;
+
+    // check divergence and convergence
+    const double lastdif = fold - fnew;
+    if ( lastdif <= -1.0 * CRIT ) break;
+    const double fdif = 2.0 * lastdif / ( fold + fnew );
+    if ( fdif <= s->FCRIT ) break;
+    fold = fnew;
+  }
+
+  // output
+  if ( dist != NULL ) memcpy( dist, d, m * sizeof( double ) );
+  if ( lastiter != NULL ) ( *lastiter ) = ( iter > s->MAXITER ? s->MAXITER : iter );
+  return fnew;
+
+} // scoreobject
+
+double scorebatch( scorer* s, const size_t n, const double* delta, const double* w, double* z, double* fvalues, size_t* lastiter )
+// Function scorebatch() scores n objects with dissimilarities delta (n by m, row major), optional weights w (n by m),
+// and coordinates z (n by p, row major); fvalues (n) and lastiter (n), if not NULL, receive the per object results.
+{
+  const size_t m = s->m;
+  const size_t p = s->p;
+  double fvalue = 0.0;
+  for ( size_t i = 0; i < n; i++ ) {
+    size_t iter = 0;
+    const double f = scoreobject( s, &delta[i * m], ( w == NULL ? NULL : &w[i * m] ), &z[i * p], NULL, &iter );
+    if ( fvalues != NULL ) fvalues[i] = f;
+    if ( lastiter != NULL ) lastiter[i] = iter;
+    fvalue += f;
+  }
+  return fvalue;
+} // scorebatch
+
+// R interface: scorers are kept in a registry (see registry.h) and identified by a handle { id, token }
+
+static registry scorers;
+
+void CRnewscorer( int* rm, int* rp, double* rfixed, int* rmaxiter, double* rfcrit, int* rhandle )
+// Function CRnewscorer() creates a scorer from the row major fixed configuration and returns its handle { id, token }, or { -1, 0 }.
+{
+  rhandle[0] = -1;
+  rhandle[1] = 0;
+  scorer* s = newscorer( ( size_t )( *rm ), ( size_t )( *rp ), rfixed, ( size_t )( *rmaxiter ), *rfcrit );
+  if ( s == NULL ) return;
+  if ( newhandle( &scorers, s, rhandle ) != 0 ) freescorer( s );
+} // CRnewscorer
+
+void CRscore( int* rhandle, int* rn, double* rdelta, double* rw, int* rhasw, double* rz, double* rfvalues, int* riters, int* rstatus )
+// Function CRscore() scores n objects with row major dissimilarities, weights, and coordinates; status is 1 for an invalid handle.
+{
+  scorer* s = ( scorer* ) gethandle( &scorers, rhandle );
+  ( *rstatus ) = ( s == NULL ? 1 : 0 );
+  if ( s == NULL ) return;
+  const size_t p = s->p;
+  const size_t m = s->m;
+  for ( size_t i = 0; i < ( size_t )( *rn ); i++ ) {
+    size_t iter = 0;
+    rfvalues[i] = scoreobject( s, &rdelta[i * m], ( *rhasw != 0 ? &rw[i * m] : NULL ), &rz[i * p], NULL, &iter );
+    riters[i] = ( int )( iter );
+  }
+} // CRscore
+
+void CRfreescorer( int* rhandle )
+// Function CRfreescorer() releases the scorer with handle { id, token }, an invalid handle is ignored.
+{
+  scorer* s = ( scorer* ) releasehandle( &scorers, rhandle );
+  if ( s != NULL ) freescorer( s );
+} // CRfreescorer
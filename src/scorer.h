@@ -0,0 +1,41 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#ifndef SCORER_H
+#define SCORER_H
+
+#include <stddef.h>
+
+// scorer: persistent external unfolding handle for a fixed column configuration
+// fixed coordinates are stored dimension major (SoA), each dimension padded and aligned to SCORERALIGN bytes,
+// together with their squared norms and column sums; scratch space for one object is part of the handle,
+// such that scoring does not allocate. A handle is not reentrant: use one handle per thread.
+// The scorer does not depend on R and can be used from any C host.
+
+#define SCORERALIGN 64
+
+typedef struct scorer_struct {
+  size_t m;          // number of fixed points
+  size_t p;          // dimensionality
+  size_t mpad;       // m rounded up to a multiple of SCORERALIGN / sizeof( double )
+  size_t MAXITER;    // maximum number of iterations per object
+  double FCRIT;      // relative convergence criterion
+  double* fixed;     // p x mpad, fixed[k * mpad + j]
+  double* norms;     // mpad, squared norms of the fixed points
+  double* sums;      // p, column sums of the fixed coordinates
+  double* dwork;     // mpad, scaled dissimilarities
+  double* b;         // mpad, B matrix row
+  double* d;         // mpad, distances
+  double* fw;        // p, weighted column sums
+  void* block;       // single allocation holding all of the above
+} scorer;
+
+extern scorer* newscorer( const size_t m, const size_t p, const double* fixed, const size_t MAXITER, const double FCRIT );
+extern double scoreobject( scorer* s, const double* delta, const double* w, double* z, double* dist, size_t* lastiter );
+extern double scorebatch( scorer* s, const size_t n, const double* delta, const double* w, double* z, double* fvalues, size_t* lastiter );
+extern void freescorer( scorer* s );
+
+#endif
@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2020 Frank M.T.A. Busing (e-mail: busing at fsw dot leidenuniv dot nl)
+// FreeBSD or 2-Clause BSD or BSD-2 License applies, see Http://www.freebsd.org/copyright/freebsd-license.html
+// This is a permissive non-copyleft free software license that is compatible with the GNU GPL.
+//
+
+#include "fmdu.h"
+
+double sprowresmdu( const size_t n, const size_t m, double** delta, const size_t p, const size_t h, const int* qp, const int* qi, const double* qx, double** b, double** y, int** fy, double** d, const size_t MAXITER, const double FCRIT, size_t* lastiter, double* lastdif, fitcontrol* control, const bool echo )
+// Function sprowresmdu() performs row restricted multidimensional unfolding with q in compressed sparse column format.
+{
+  const double EPS = DBL_EPSILON;                                              // 2.2204460492503131e-16
+  const double TOL = sqrt( EPS );                                              // 1.4901161193847656e-08
+  const double CRIT = sqrt( TOL );                                             // 0.00012207031250000000
+  const double TINY = pow( 10.0, ( log10( EPS ) + log10( TOL ) ) / 2.0 );  // 1.8189894035458617e-12
+
+  // allocate memory
+  double** x = getmatrix( n, p, 0.0 );
+  double** imb = getmatrix( n, m, 0.0 );
+  double** xtilde = getmatrix( n, p, 0.0 );
+  double** ytilde = getmatrix( m, p, 0.0 );
+  double** hhp = getmatrix( h, p, 0.0 );
+  double* hmp = getvector( p, 0.0 );
+
+  // initialization
+  double wr = ( double ) ( m );
+  double wc = ( double ) ( n );
+  double scale = 0.0;
+  for ( size_t i = 1; i <= n; i++ ) {
+    for ( size_t j = 1; j <= m; j++ ) {
+      const double work = delta[i][j];
+      scale += work * work;
+    }
+  }
+  int nfy = 0;
+  for ( size_t j = 1; j <= m; j++ ) for ( size_t k = 1; k <= p; k++ ) nfy += fy[j][k];
+
+  // update distances and calculate normalized stress
+  cscmm( n, h, qp, qi, qx, p, b, x );
+  double fold = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
+  fold /= scale;
+  double fnew = 0.0;
+
+  // record and echo intermediate results
+  traceiteration( control, echo, firstiteration( control ) - 1, fold, fold, n, m, d, TINY );
+
+  // start main loop
+  size_t iter = 0;
+  for ( iter = firstiteration( control ); iter <= MAXITER; iter++ ) {
+    PROFILESTART( );
+
+    // compute preliminary updates: xtilde and ytilde
+    for ( size_t i = 1; i <= n; i++ ) {
+      double rsb = 0.0;
+      for ( size_t k = 1; k <= m; k++ ) rsb += imb[i][k];
+      for ( size_t j = 1; j <= p; j++ ) {
+        double work = 0.0;
+        for ( size_t k = 1; k <= m; k++ ) work += imb[i][k] * y[k][j];
+        xtilde[i][j] = rsb * x[i][j] - work;
+      }
+    }
+    for ( size_t i = 1; i <= m; i++ ) {
+      double csb = 0.0;
+      for ( size_t k = 1; k <= n; k++ ) csb += imb[k][i];
+      for ( size_t j = 1; j <= p; j++ ) {
+        double work = 0.0;
+        for ( size_t k = 1; k <= n; k++ ) work += imb[k][i] * x[k][j];
+        ytilde[i][j] = csb * y[i][j] - work;
+      }
+    }
+    PROFILESTOP( control, PHASE.TILDE, 4.0 * n * m * p + 2.0 * n * m, 16.0 * n * m );
+
+    // update b: solve wr q'q b = q'( xtilde + 1 colsum( y ) ) from the previous b
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t j = 1; j <= m; j++ ) work += y[j][k];
+      hmp[k] = work;
+    }
+    for ( size_t i = 1; i <= n; i++ ) for ( size_t k = 1; k <= p; k++ ) xtilde[i][k] += hmp[k];
+    csctmm( n, h, qp, qi, qx, p, xtilde, hhp );
+    csccg( n, h, qp, qi, qx, wr, p, hhp, b, h, TOL );
+
+    // update x
+    cscmm( n, h, qp, qi, qx, p, b, x );
+
+    // update y
+    for ( size_t k = 1; k <= p; k++ ) {
+      double work = 0.0;
+      for ( size_t i = 1; i <= n; i++ ) work += x[i][k];
+      hmp[k] = work;
+    }
+    for ( size_t i = 1; i <= m; i++ ) {
+      for ( size_t j = 1; j <= p; j++ ) if ( fy[i][j] == 0 ) y[i][j] = ( ytilde[i][j] + hmp[j] ) / wc;
+    }
+    PROFILESTOP( control, PHASE.UPDATE, 2.0 * n * m * p, 16.0 * ( n + m ) * p );
+
+    // update distances and calculate normalized stress
+    fnew = fusedstress( n, p, x, m, y, delta, NULL, TINY, d, imb );
+    fnew /= scale;
+    PROFILESTOP( control, PHASE.DISTANCE, 3.0 * n * m * p + 6.0 * n * m, 24.0 * n * m );
+
+    // record and echo intermediate results
+    traceiteration( control, echo, iter, fold, fnew, n, m, d, TINY );
+
+    // check convergence
+    ( *lastdif ) = fold - fnew;
+    if ( ( *lastdif ) <= -1.0 * CRIT ) break;
+    double fdif = 2.0 * ( *lastdif ) / ( fold + fnew );
+    if ( fdif <= FCRIT ) break;
+    fold = fnew;
+
+    // write checkpoint when due
+    checkpoint( control, iter, fold, n, m, p, x, y, h, b, 0, NULL );
+
+    // stop when the time budget is exhausted
+    if ( outoftime( control ) ) break;
+  }
+  ( *lastiter ) = iter;
+  setstatus( control, iter <= MAXITER, ( *lastdif ) <= -1.0 * CRIT );
+
+  // rotate to principal axes of x
+  if ( nfy == 0 ) rotateplusplus( n, p, x, h, b, m, y );
+
+  // de-allocate memory
+  freematrix( x );
+  freematrix( imb );
+  freematrix( xtilde );
+  freematrix( ytilde );
+  freematrix( hhp );
+  freevector( hmp );
+
+  return( fnew );
+} // sprowresmdu
+
+void Csprowresmdu( int* rn, int* rm, double* rdelta, int* rp, int* rh, int* rqp, int* rqi, double* rqx, double* rb, double* ry, int* rfy, double* rd, int* rmaxiter, double* rfdif, double* rfvalue, char** rcheckpoint, int* rinterval, int* rfirstiter, double* rbudget, int* rstatus, double* rtrace, int* rntrace, double* rprofile, int* recho )
+// Function Csprowresmdu() performs row restricted multidimensional unfolding with sparse q.
+{
+  // transfer to C
+  size_t n = *rn;
+  size_t m = *rm;
+  size_t h = *rh;
+  size_t p = *rp;
+  size_t MAXITER = *rmaxiter;
+  double** delta = getmatrix( n, m, 0.0 );
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) delta[i][j] = rdelta[k];
+  double** b = getmatrix( h, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) b[i][j] = rb[k];
+  double** y = getmatrix( m, p, 0.0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) y[i][j] = ry[k];
+  int** fy = getimatrix( m, p, 0 );
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) fy[i][j] = rfy[k];
+  double** d = getmatrix( n, m, 0.0 );
+  double FCRIT = *rfdif;
+  bool echo = ( *recho ) != 0;
+  fitcontrol control = setcontrol( *rcheckpoint, *rinterval, *rfirstiter, *rbudget );
+  settrace( &control, rtrace, *rntrace, *recho );
+
+  // run function
+  size_t lastiter = 0;
+  double lastdif = 0.0;
+  double fvalue = sprowresmdu( n, m, delta, p, h, rqp, rqi, rqx, b, y, fy, d, MAXITER, FCRIT, &lastiter, &lastdif, &control, echo );
+
+  // transfer to R
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= h; i++, k++ ) rb[k] = b[i][j];
+  for ( size_t j = 1, k = 0; j <= p; j++ ) for ( size_t i = 1; i <= m; i++, k++ ) ry[k] = y[i][j];
+  for ( size_t j = 1, k = 0; j <= m; j++ ) for ( size_t i = 1; i <= n; i++, k++ ) rd[k] = d[i][j];
+  ( *rmaxiter ) = ( int ) ( lastiter );
+  ( *rfdif ) = lastdif;
+  ( *rfvalue ) = fvalue;
+  ( *rstatus ) = control.status;
+  ( *rntrace ) = ( int )( control.ntrace );
+  for ( size_t k = 0; k < 3 * PROFILEPHASES; k++ ) rprofile[k] = control.profile[k];
+
+  // de-allocate memory
+  freematrix( delta );
+  freematrix( b );
+  freematrix( y );
+  freeimatrix( fy );
+  freematrix( d );
+
+} // Csprowresmdu